@@ -0,0 +1,734 @@
+#include "Audio.h"
+#include "AudioCache.h"
+#include "AudioCommandQueue.h"
+#include "AudioStream.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+#include "VoicePool.h"
+#include<AL/al.h>
+#include<AL/alc.h>
+#include<AL/alext.h>
+#include<AudioFile/AudioFile.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include<string>
+#include <thread>
+
+//OpenAL error checking
+#define OpenAL_ErrorCheck(message)\
+{\
+	ALenum error = alGetError();\
+	if( error != AL_NO_ERROR)\
+	{\
+		std::cerr << "OpenAL Error: " << error << " with call for " << #message << std::endl;\
+	}\
+}
+
+#define alec(FUNCTION_CALL)\
+FUNCTION_CALL;\
+OpenAL_ErrorCheck(FUNCTION_CALL)
+
+std::string audioFilePaths[] = { "sounds/cannon.wav", "sounds/Explosion.wav", "sounds/missileGround.wav" };
+const int numberOfAudioTracks = sizeof(audioFilePaths) / sizeof(audioFilePaths[0]);
+
+//0 -> cannon, 1 -> explosion with tank, 2->Ground hit
+ALuint audioBuffers[numberOfAudioTracks];
+
+//How much each track matters when every voice is busy; a hit is never cut off by a shot or a miss
+const int trackPriorities[numberOfAudioTracks] = { 1, 2, 0 };
+
+//Length of each track in seconds, known once its buffer is filled
+static double trackDurations[numberOfAudioTracks];
+
+//Sources shared by all the tracks, so the same effect can overlap itself
+const int numberOfVoices = 16;
+static VoicePool voicePool;
+
+//Long sounds such as music are streamed through a few buffers on their own sources, so sound
+//effects never steal them. Slots are claimed by PlayAudioStream and freed by the audio thread
+const int maxNumberOfStreams = 2;
+struct StreamPlayer
+{
+	std::unique_ptr<AudioStream> stream;
+	ALuint source = 0;
+	ALuint buffers[AudioStream::NumberOfChunks] = {};
+	ALuint freeBuffers[AudioStream::NumberOfChunks] = {};
+	int numberOfFreeBuffers = 0;
+};
+static StreamPlayer streamPlayers[maxNumberOfStreams];
+static std::atomic<bool> isStreamSlotTaken[maxNumberOfStreams];
+
+static ALCdevice* device = nullptr;
+static ALCcontext* context = nullptr;
+
+//Sounds are decoded on worker threads and handed to OpenAL by the audio thread
+enum class SoundState
+{
+	Loading,
+	Decoded, //Decoded but not yet in an OpenAL buffer
+	Ready,
+	Failed
+};
+
+static std::unique_ptr<ThreadPool> assetLoadingPool;
+static CachedSound decodedSounds[numberOfAudioTracks];
+static std::atomic<SoundState> soundStates[numberOfAudioTracks];
+
+//Float formats come from an extension, so they are looked up once by InitializeAudio
+//rather than by the worker threads
+static ALenum monoFloat32Format = AL_NONE;
+static ALenum stereoFloat32Format = AL_NONE;
+
+//After InitializeAudio only the audio thread talks to OpenAL. The game thread queues commands for
+//it, which the audio thread submits in batches
+static AudioCommandQueue audioCommands;
+static std::thread audioThread;
+static std::mutex audioThreadMutex;
+static std::condition_variable audioThreadCondition;
+static bool isAudioThreadRunning = false;
+
+//How long the audio thread sleeps between batches
+const std::chrono::milliseconds AudioThreadInterval(2);
+
+//From AL_SOFT_deferred_updates, which holds back a batch's changes until all of them are made.
+//Left null if the driver does not have it
+static LPALDEFERUPDATESSOFT deferUpdates = nullptr;
+static LPALPROCESSUPDATESSOFT processUpdates = nullptr;
+
+//Set by InitializeLoopbackAudio. Audio is then mixed into renderedSamples by RenderAudioTick on the
+//game thread instead of being played by the audio thread, and time is counted in mixed frames
+static bool isLoopback = false;
+static LPALCRENDERSAMPLESSOFT renderSamples = nullptr;
+static unsigned int loopbackSampleRate = 0;
+static std::vector<float> renderedSamples; //Interleaved stereo
+static long long renderedFrames = 0;
+static double renderedSeconds = 0;
+static AudioRenderStatistics renderStatistics;
+
+//Seconds on the clock voices are timed by
+static double GetAudioTime()
+{
+	if (isLoopback)
+	{
+		return (double)renderedFrames / loopbackSampleRate;
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//Returns how many bytes one sample frame of an OpenAL format takes
+static int GetBytesPerFrame(ALenum format)
+{
+	if (format == AL_FORMAT_MONO8)
+	{
+		return 1;
+	}
+	if (format == AL_FORMAT_MONO16 || format == AL_FORMAT_STEREO8)
+	{
+		return 2;
+	}
+	if (format == AL_FORMAT_STEREO16 || format == monoFloat32Format)
+	{
+		return 4;
+	}
+	return 8; //Stereo float
+}
+
+//Returns the OpenAL format that plays samples stored like this without conversion, or AL_NONE if there is none
+static ALenum GetOpenALFormat(int numChannels, int bitDepth, bool isFloat)
+{
+	if (numChannels != 1 && numChannels != 2)
+	{
+		return AL_NONE;
+	}
+	bool isStereo = numChannels == 2;
+
+	if (isFloat)
+	{
+		return bitDepth == 32 ? (isStereo ? stereoFloat32Format : monoFloat32Format) : AL_NONE;
+	}
+
+	if (bitDepth == 16)
+	{
+		return isStereo ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
+	}
+	if (bitDepth == 8)
+	{
+		return isStereo ? AL_FORMAT_STEREO8 : AL_FORMAT_MONO8;
+	}
+	return AL_NONE;
+}
+
+//Decodes a .wav file into data alBufferData can take. Samples OpenAL can play as they are are copied
+//straight from the file; anything else is decoded and converted to 16 bit first
+static bool DecodeSound(const std::string& filePath, DecodedSound& sound)
+{
+	AudioFile<float> soundFile;
+	if (!soundFile.loadRawPCM(filePath))
+	{
+		return false;
+	}
+	sound.sampleRate = soundFile.getSampleRate();
+
+	sound.format = GetOpenALFormat(soundFile.getNumChannels(), soundFile.getBitDepth(), soundFile.isRawPCMFloat());
+	if (sound.format != AL_NONE)
+	{
+		sound.pcmData.assign(soundFile.getRawPCMData(), soundFile.getRawPCMData() + soundFile.getRawPCMSize());
+		return true;
+	}
+
+	//Mono or stereo 16 bit is always playable, so convert everything else to that
+	if (!soundFile.load(filePath) || soundFile.getNumChannels() > 2)
+	{
+		return false;
+	}
+	soundFile.setBitDepth(16);
+	soundFile.writePCMToBuffer(sound.pcmData); //remember, we added this function to the AudioFile library
+
+	sound.format = soundFile.isStereo() ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
+	return true;
+}
+
+//Decoded copies of the sound effects, kept next to them
+static const AudioCache audioCache("sounds/cache", DecodeSound);
+
+void OpenALAudioBackend::PlayAudio(int trackIndex)
+{
+	//0->cannon
+	//1->explosion
+	//2->ground hit
+	if (!audioCommands.Push({ AudioCommandType::PlayTrack, trackIndex, nullptr }))
+	{
+		LOG_DEBUG("Audio command queue is full, skipping " << audioFilePaths[trackIndex]);
+	}
+}
+
+int PlayAudioStream(const std::string& filePath, bool isLooping)
+{
+	for (int i = 0; i < maxNumberOfStreams; i++)
+	{
+		bool isTaken = false;
+		if (!isStreamSlotTaken[i].compare_exchange_strong(isTaken, true, std::memory_order_acquire))
+		{
+			continue;
+		}
+
+		std::unique_ptr<AudioStream> stream = std::make_unique<AudioStream>(filePath, isLooping, monoFloat32Format != AL_NONE);
+		if (!audioCommands.Push({ AudioCommandType::StartStream, i, stream.get() }))
+		{
+			isStreamSlotTaken[i].store(false, std::memory_order_release);
+			return -1;
+		}
+		stream.release();
+		return i;
+	}
+	LOG_WARNING("No free stream for " << filePath);
+	return -1;
+}
+
+void StopAudioStream(int streamId)
+{
+	if (streamId >= 0 && streamId < maxNumberOfStreams)
+	{
+		audioCommands.Push({ AudioCommandType::StopStream, streamId, nullptr });
+	}
+}
+
+//Stops a stream's source, takes its buffers back and frees its slot for PlayAudioStream
+static void ReleaseStream(int streamIndex)
+{
+	StreamPlayer& player = streamPlayers[streamIndex];
+	alSourceStop(player.source);
+	alSourcei(player.source, AL_BUFFER, 0);
+	for (int i = 0; i < AudioStream::NumberOfChunks; i++)
+	{
+		player.freeBuffers[i] = player.buffers[i];
+	}
+	player.numberOfFreeBuffers = AudioStream::NumberOfChunks;
+
+	//Waits for the decoding thread, which stops as soon as it is told to
+	player.stream.reset();
+	isStreamSlotTaken[streamIndex].store(false, std::memory_order_release);
+}
+
+//Swaps the buffers each stream has finished playing for newly decoded chunks
+static void UpdateStreams()
+{
+	for (int i = 0; i < maxNumberOfStreams; i++)
+	{
+		StreamPlayer& player = streamPlayers[i];
+		if (!player.stream)
+		{
+			continue;
+		}
+		AudioStream& stream = *player.stream;
+
+		//The loopback mix takes its chunks at the same points of every run, however fast the decoder is
+		if (isLoopback)
+		{
+			stream.WaitForChunks();
+		}
+
+		if (stream.HasFailed())
+		{
+			LOG_ERROR("failed to stream the sound file " << stream.GetFilePath());
+			ReleaseStream(i);
+			continue;
+		}
+
+		ALint processedBuffers = 0;
+		alGetSourcei(player.source, AL_BUFFERS_PROCESSED, &processedBuffers);
+		for (; processedBuffers > 0; processedBuffers--)
+		{
+			alSourceUnqueueBuffers(player.source, 1, &player.freeBuffers[player.numberOfFreeBuffers++]);
+		}
+
+		AudioStream::Chunk chunk;
+		while (player.numberOfFreeBuffers > 0 && stream.PeekChunk(chunk))
+		{
+			ALuint buffer = player.freeBuffers[--player.numberOfFreeBuffers];
+			ALenum format = GetOpenALFormat(stream.GetNumChannels(), stream.GetBitDepth(), stream.IsFloat());
+			alBufferData(buffer, format, chunk.data, (ALsizei)chunk.size, stream.GetSampleRate());
+			alSourceQueueBuffers(player.source, 1, &buffer);
+			stream.PopChunk();
+		}
+
+		ALint state = AL_STOPPED;
+		alGetSourcei(player.source, AL_SOURCE_STATE, &state);
+		if (state != AL_PLAYING)
+		{
+			if (player.numberOfFreeBuffers < AudioStream::NumberOfChunks)
+			{
+				//Either just started, or the decoder fell behind and the source ran dry
+				alSourcePlay(player.source);
+			}
+			else if (stream.IsFinished())
+			{
+				ReleaseStream(i);
+			}
+		}
+	}
+}
+
+//Hands sound effects that have finished decoding to OpenAL
+static void UploadDecodedSounds()
+{
+	for (int i = 0; i < numberOfAudioTracks; i++)
+	{
+		if (soundStates[i].load(std::memory_order_acquire) != SoundState::Decoded)
+		{
+			continue;
+		}
+
+		CachedSound& sound = decodedSounds[i];
+		alBufferData(audioBuffers[i], sound.format, sound.pcmData, (ALsizei)sound.pcmSize, sound.sampleRate);
+		trackDurations[i] = (double)sound.pcmSize / GetBytesPerFrame(sound.format) / sound.sampleRate;
+
+		//OpenAL has its own copy now
+		sound.cacheFile.Close();
+		sound.decodedData = std::vector<uint8_t>();
+		sound.pcmData = nullptr;
+
+		soundStates[i].store(SoundState::Ready, std::memory_order_relaxed);
+	}
+}
+
+static void RunAudioCommand(const AudioCommand& command)
+{
+	switch (command.type)
+	{
+	case AudioCommandType::PlayTrack:
+		if (soundStates[command.index].load(std::memory_order_relaxed) != SoundState::Ready)
+		{
+			//Still loading or failed to load, so the effect is skipped rather than waited for
+			LOG_DEBUG("Sound " << audioFilePaths[command.index] << " is not loaded, skipping it");
+		}
+		else if (!voicePool.Play(audioBuffers[command.index], trackPriorities[command.index], trackDurations[command.index], GetAudioTime()))
+		{
+			LOG_DEBUG("No free voice for " << audioFilePaths[command.index] << ", skipping it");
+		}
+		break;
+
+	case AudioCommandType::StartStream:
+		streamPlayers[command.index].stream.reset(command.stream);
+		break;
+
+	case AudioCommandType::StopStream:
+		if (streamPlayers[command.index].stream)
+		{
+			ReleaseStream(command.index);
+		}
+		break;
+	}
+}
+
+//Submits everything queued since the last batch as one deferred update, and checks for errors once for the whole batch
+static void SubmitAudioBatch()
+{
+	AudioCommand commands[AudioCommandQueue::Capacity];
+	int numberOfCommands = audioCommands.Pop(commands, AudioCommandQueue::Capacity);
+
+	unsigned long long droppedCommands = audioCommands.TakeDroppedCommands();
+	if (droppedCommands > 0)
+	{
+		LOG_WARNING(droppedCommands << " audio commands dropped");
+	}
+
+	bool hasWork = numberOfCommands > 0;
+	for (int i = 0; i < numberOfAudioTracks; i++)
+	{
+		hasWork |= soundStates[i].load(std::memory_order_relaxed) == SoundState::Decoded;
+	}
+	for (int i = 0; i < maxNumberOfStreams; i++)
+	{
+		hasWork |= streamPlayers[i].stream != nullptr;
+	}
+	if (!hasWork)
+	{
+		return;
+	}
+
+	if (deferUpdates)
+	{
+		deferUpdates();
+	}
+
+	UploadDecodedSounds();
+	for (int i = 0; i < numberOfCommands; i++)
+	{
+		RunAudioCommand(commands[i]);
+	}
+	UpdateStreams();
+
+	if (processUpdates)
+	{
+		processUpdates();
+	}
+
+	ALenum error = alGetError();
+	if (error != AL_NO_ERROR)
+	{
+		LOG_ERROR("OpenAL Error: " << error << " in a batch of " << numberOfCommands << " audio commands");
+	}
+}
+
+static void RunAudioThread()
+{
+	std::unique_lock<std::mutex> lock(audioThreadMutex);
+	while (isAudioThreadRunning)
+	{
+		audioThreadCondition.wait_for(lock, AudioThreadInterval);
+
+		lock.unlock();
+		SubmitAudioBatch();
+		lock.lock();
+	}
+}
+
+//Creates a context on device and everything the sounds play through, then starts decoding them
+static bool SetUpContext(const ALCint* attributes)
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Create an OpenAL audio context from the device
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	context = alcCreateContext(device, attributes);
+	OpenAL_ErrorCheck(context);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Activate this context so that OpenAL state modifications are applied to the context
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	if (!alcMakeContextCurrent(context))
+	{
+		std::cerr << "failed to make the OpenAL context the current context" << std::endl;
+		return false;
+	}
+	OpenAL_ErrorCheck("Make context current");
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Create a listener in 3d space (ie the player); (there always exists as listener, you just configure data on it)
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	alec(alListener3f(AL_POSITION, 0.f, 0.f, 0.f));
+	alec(alListener3f(AL_VELOCITY, 0.f, 0.f, 0.f));
+	ALfloat forwardAndUpVectors[] = {
+		/*forward = */ 1.f, 0.f, 0.f,
+		/* up = */ 0.f, 1.f, 0.f
+	};
+	alec(alListenerfv(AL_ORIENTATION, forwardAndUpVectors));
+
+	//Float samples need the AL_EXT_float32 extension, which has no header constants of its own
+	if (alIsExtensionPresent("AL_EXT_float32"))
+	{
+		monoFloat32Format = alGetEnumValue("AL_FORMAT_MONO_FLOAT32");
+		stereoFloat32Format = alGetEnumValue("AL_FORMAT_STEREO_FLOAT32");
+	}
+
+	if (alIsExtensionPresent("AL_SOFT_deferred_updates"))
+	{
+		deferUpdates = (LPALDEFERUPDATESSOFT)alGetProcAddress("alDeferUpdatesSOFT");
+		processUpdates = (LPALPROCESSUPDATESSOFT)alGetProcAddress("alProcessUpdatesSOFT");
+		if (!deferUpdates || !processUpdates)
+		{
+			deferUpdates = nullptr;
+			processUpdates = nullptr;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// create the sound sources that play our sounds (from the sound buffers)
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	if (!voicePool.Create(numberOfVoices))
+	{
+		LOG_WARNING("OpenAL only gave " << voicePool.GetNumberOfVoices() << " of " << numberOfVoices << " voices");
+	}
+
+	for (int i = 0; i < maxNumberOfStreams; i++)
+	{
+		StreamPlayer& player = streamPlayers[i];
+		alec(alGenSources(1, &player.source));
+		alec(alSource3f(player.source, AL_POSITION, 1.f, 0.f, 0.f));
+		alec(alSourcei(player.source, AL_LOOPING, AL_FALSE));
+		alec(alGenBuffers(AudioStream::NumberOfChunks, player.buffers));
+		for (int j = 0; j < AudioStream::NumberOfChunks; j++)
+		{
+			player.freeBuffers[j] = player.buffers[j];
+		}
+		player.numberOfFreeBuffers = AudioStream::NumberOfChunks;
+		isStreamSlotTaken[i] = false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Create buffers that hold our sound data; these are shared between contexts and ar defined at a device level
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	alec(alGenBuffers(numberOfAudioTracks, audioBuffers));
+
+	//Decode the sounds in the background, so the window can open while they load
+	assetLoadingPool = std::make_unique<ThreadPool>(2);
+	for (int i = 0; i < numberOfAudioTracks; i++)
+	{
+		soundStates[i] = SoundState::Loading;
+		assetLoadingPool->Submit([i]()
+			{
+				bool isDecoded = audioCache.Load(audioFilePaths[i], decodedSounds[i]);
+				if (!isDecoded)
+				{
+					LOG_ERROR("failed to load the sound file " << audioFilePaths[i]);
+				}
+				soundStates[i].store(isDecoded ? SoundState::Decoded : SoundState::Failed, std::memory_order_release);
+			});
+	}
+
+	return true;
+}
+
+bool InitializeAudio()
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// find the default audio device
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	const ALCchar* defaultDeviceString = alcGetString(/*device*/nullptr, ALC_DEFAULT_DEVICE_SPECIFIER);
+	device = alcOpenDevice(defaultDeviceString);
+	if (!device)
+	{
+		std::cerr << "failed to get the default device for OpenAL" << std::endl;
+		return false;
+	}
+	std::cout << "OpenAL Device: " << alcGetString(device, ALC_DEVICE_SPECIFIER) << std::endl;
+
+	if (!SetUpContext(nullptr))
+	{
+		return false;
+	}
+
+	isAudioThreadRunning = true;
+	audioThread = std::thread(RunAudioThread);
+
+	return true;
+}
+
+bool InitializeLoopbackAudio(unsigned int sampleRate)
+{
+	if (!alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback"))
+	{
+		std::cerr << "OpenAL has no loopback device (ALC_SOFT_loopback)" << std::endl;
+		return false;
+	}
+	LPALCLOOPBACKOPENDEVICESOFT loopbackOpenDevice = (LPALCLOOPBACKOPENDEVICESOFT)alcGetProcAddress(nullptr, "alcLoopbackOpenDeviceSOFT");
+	LPALCISRENDERFORMATSUPPORTEDSOFT isRenderFormatSupported = (LPALCISRENDERFORMATSUPPORTEDSOFT)alcGetProcAddress(nullptr, "alcIsRenderFormatSupportedSOFT");
+	renderSamples = (LPALCRENDERSAMPLESSOFT)alcGetProcAddress(nullptr, "alcRenderSamplesSOFT");
+	if (!loopbackOpenDevice || !isRenderFormatSupported || !renderSamples)
+	{
+		std::cerr << "failed to load the OpenAL loopback functions" << std::endl;
+		return false;
+	}
+
+	device = loopbackOpenDevice(nullptr);
+	if (!device)
+	{
+		std::cerr << "failed to open an OpenAL loopback device" << std::endl;
+		return false;
+	}
+	if (!isRenderFormatSupported(device, (ALCsizei)sampleRate, ALC_STEREO_SOFT, ALC_FLOAT_SOFT))
+	{
+		std::cerr << "OpenAL cannot mix stereo float at " << sampleRate << " Hz" << std::endl;
+		alcCloseDevice(device);
+		device = nullptr;
+		return false;
+	}
+
+	//A loopback device mixes in whatever format the context asks for
+	ALCint attributes[] = {
+		ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+		ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+		ALC_FREQUENCY, (ALCint)sampleRate,
+		0
+	};
+
+	isLoopback = true;
+	loopbackSampleRate = sampleRate;
+	renderedSamples.clear();
+	renderedFrames = 0;
+	renderedSeconds = 0;
+	renderStatistics = AudioRenderStatistics();
+
+	if (!SetUpContext(attributes))
+	{
+		return false;
+	}
+
+	//Every sound has to be there from the first tick for the output to be the same every run
+	assetLoadingPool->WaitForAll();
+	UploadDecodedSounds();
+	return true;
+}
+
+void RenderAudioTick(double tickSeconds)
+{
+	if (!isLoopback)
+	{
+		return;
+	}
+
+	//Counting from the start keeps ticks that are not a whole number of frames from drifting
+	renderedSeconds += tickSeconds;
+	long long framesToRender = (long long)(renderedSeconds * loopbackSampleRate) - renderedFrames;
+
+	//Growing the output is not part of the cost of mixing, so it happens before the clock starts
+	size_t start = renderedSamples.size();
+	renderedSamples.resize(start + (framesToRender > 0 ? framesToRender : 0) * 2);
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	SubmitAudioBatch();
+	if (framesToRender > 0)
+	{
+		renderSamples(device, renderedSamples.data() + start, (ALCsizei)framesToRender);
+		renderedFrames += framesToRender;
+	}
+
+	double tickRenderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	renderStatistics.ticks++;
+	renderStatistics.totalSeconds += tickRenderSeconds;
+	if (tickRenderSeconds > renderStatistics.maxSeconds)
+	{
+		renderStatistics.maxSeconds = tickRenderSeconds;
+	}
+}
+
+bool SaveRenderedAudio(const std::string& filePath)
+{
+	if (!isLoopback)
+	{
+		return false;
+	}
+
+	AudioFile<float> outputFile;
+	outputFile.setNumChannels(2);
+	outputFile.setNumSamplesPerChannel((int)renderedFrames);
+	outputFile.setSampleRate(loopbackSampleRate);
+	outputFile.setBitDepth(32);
+	for (long long i = 0; i < renderedFrames; i++)
+	{
+		outputFile.samples[0][i] = renderedSamples[i * 2];
+		outputFile.samples[1][i] = renderedSamples[i * 2 + 1];
+	}
+	return outputFile.save(filePath);
+}
+
+AudioRenderStatistics GetAudioRenderStatistics()
+{
+	return renderStatistics;
+}
+
+void LoopbackAudioBackend::OnSimulationTick()
+{
+	RenderAudioTick(tickSeconds);
+}
+
+bool IsAudioLoadingFinished()
+{
+	for (int i = 0; i < numberOfAudioTracks; i++)
+	{
+		SoundState state = soundStates[i].load(std::memory_order_acquire);
+		if (state == SoundState::Loading || state == SoundState::Decoded)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void ShutdownAudio()
+{
+	{
+		std::lock_guard<std::mutex> lock(audioThreadMutex);
+		isAudioThreadRunning = false;
+	}
+	audioThreadCondition.notify_one();
+	if (audioThread.joinable())
+	{
+		audioThread.join();
+	}
+
+	//Let any sounds still being decoded finish before the buffers they are meant for go away
+	assetLoadingPool.reset();
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// clean up our resources!
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Streams started after the audio thread's last batch were never picked up
+	AudioCommand command;
+	while (audioCommands.Pop(&command, 1) > 0)
+	{
+		if (command.type == AudioCommandType::StartStream)
+		{
+			delete command.stream;
+		}
+	}
+
+	voicePool.Destroy();
+	for (int i = 0; i < maxNumberOfStreams; i++)
+	{
+		StreamPlayer& player = streamPlayers[i];
+		if (player.stream)
+		{
+			ReleaseStream(i);
+		}
+		alec(alDeleteSources(1, &player.source));
+		alec(alDeleteBuffers(AudioStream::NumberOfChunks, player.buffers));
+	}
+	for (int i = 0; i < numberOfAudioTracks; i++)
+	{
+		decodedSounds[i].cacheFile.Close();
+		decodedSounds[i].decodedData = std::vector<uint8_t>();
+	}
+	alec(alDeleteBuffers(numberOfAudioTracks, audioBuffers));
+	alcMakeContextCurrent(nullptr);
+	alcDestroyContext(context);
+	alcCloseDevice(device);
+
+	isLoopback = false;
+	renderedSamples = std::vector<float>();
+}
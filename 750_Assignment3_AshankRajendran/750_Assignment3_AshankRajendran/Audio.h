@@ -0,0 +1,66 @@
+#pragma once
+#include "Backends.h"
+#include <string>
+
+//Opens the default OpenAL device, starts the audio thread and starts decoding every sound effect in
+//audioFilePaths on background threads, without waiting for them. Returns false if the device could
+//not be set up
+bool InitializeAudio();
+
+//Opens an OpenAL loopback device (ALC_SOFT_loopback), which mixes stereo float into memory at
+//sampleRate instead of playing through a sound card. Every sound effect is loaded before it returns,
+//and nothing is mixed until RenderAudioTick is called. Returns false if OpenAL has no loopback device
+bool InitializeLoopbackAudio(unsigned int sampleRate);
+
+//Submits the queued audio commands and mixes the next tickSeconds of audio on the calling thread.
+//Only does anything after InitializeLoopbackAudio
+void RenderAudioTick(double tickSeconds);
+
+//Writes everything mixed since InitializeLoopbackAudio to a 32 bit float .wav file
+bool SaveRenderedAudio(const std::string& filePath);
+
+//Wall clock time RenderAudioTick has spent submitting and mixing
+struct AudioRenderStatistics
+{
+	long long ticks = 0;
+	double totalSeconds = 0;
+	double maxSeconds = 0;
+};
+
+AudioRenderStatistics GetAudioRenderStatistics();
+
+//Starts streaming a long .wav file, such as music, from disk a few chunks at a time. Returns an id
+//for StopAudioStream, or -1 if every stream is in use. A stream that is not looping ends on its own
+//at the end of the file, after which its id can be handed out again. After InitializeLoopbackAudio the
+//stream starts with the next RenderAudioTick and renders the same way every run
+int PlayAudioStream(const std::string& filePath, bool isLooping);
+
+void StopAudioStream(int streamId);
+
+//Returns true once every sound effect has either been loaded or failed to load
+bool IsAudioLoadingFinished();
+
+//Stops the audio thread and releases the sound sources, the context and the device opened by InitializeAudio
+void ShutdownAudio();
+
+//Plays the sound effects loaded by InitializeAudio. Requests are queued for the audio thread, so
+//PlayAudio never waits on the driver; sounds that are not loaded yet are skipped. Call only from
+//the game thread
+class OpenALAudioBackend : public AudioBackend
+{
+public:
+	void PlayAudio(int trackIndex) override;
+};
+
+//Mixes one tick's worth of audio through the loopback device after every simulation step, so the
+//same match always renders the same output. Needs InitializeLoopbackAudio
+class LoopbackAudioBackend : public OpenALAudioBackend
+{
+public:
+	explicit LoopbackAudioBackend(double tickSeconds) : tickSeconds(tickSeconds) {}
+
+	void OnSimulationTick() override;
+
+private:
+	double tickSeconds;
+};
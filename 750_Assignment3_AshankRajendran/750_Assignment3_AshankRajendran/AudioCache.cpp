@@ -0,0 +1,185 @@
+#include "AudioCache.h"
+#include "Logger.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+static const char AudioCacheMagic[8] = { 'T', 'A', 'N', 'K', 'P', 'C', 'M', 0 };
+static const unsigned int AudioCacheVersion = 1;
+
+//Samples start on a cache line boundary
+static const unsigned int AudioCacheDataAlignment = 64;
+
+//Start of every cache file. Written in the machine's own byte order, which the magic and version guard
+struct AudioCacheHeader
+{
+	char magic[8];
+	uint32_t version;
+	int32_t format;
+	uint64_t sourceHash;
+	uint64_t sourceSize;
+	uint32_t sampleRate;
+	uint32_t dataOffset;
+	uint64_t dataSize;
+};
+
+//64 bit FNV-1a, taken a word at a time so hashing keeps up with reading the file
+static unsigned long long HashBytes(const uint8_t* bytes, size_t size)
+{
+	const uint64_t prime = 1099511628211ULL;
+	uint64_t hash = 14695981039346656037ULL;
+
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, bytes + i, sizeof(word));
+		hash = (hash ^ word) * prime;
+	}
+	for (; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * prime;
+	}
+	return (hash ^ size) * prime;
+}
+
+static void CreateDirectoryIfMissing(const string& directory)
+{
+#ifdef _WIN32
+	_mkdir(directory.c_str());
+#else
+	mkdir(directory.c_str(), 0755);
+#endif
+}
+
+AudioCache::AudioCache(const string& cacheDirectory, Decoder decoder)
+	: cacheDirectory(cacheDirectory), decoder(decoder)
+{
+}
+
+bool AudioCache::Load(const string& sourcePath, CachedSound& sound) const
+{
+	unsigned long long sourceHash;
+	unsigned long long sourceSize;
+	{
+		MappedFile sourceFile;
+		if (!sourceFile.Open(sourcePath))
+		{
+			return false;
+		}
+		sourceHash = HashBytes(sourceFile.GetData(), sourceFile.GetSize());
+		sourceSize = sourceFile.GetSize();
+	}
+
+	char hashText[17];
+	snprintf(hashText, sizeof(hashText), "%016llx", sourceHash);
+	string cachePath = cacheDirectory + "/" + hashText + ".pcm";
+
+	if (LoadCacheFile(cachePath, sourceHash, sourceSize, sound))
+	{
+		LOG_DEBUG("Loaded " << sourcePath << " from the audio cache");
+		return true;
+	}
+
+	DecodedSound decodedSound;
+	if (!decoder(sourcePath, decodedSound))
+	{
+		return false;
+	}
+	WriteCacheFile(cachePath, sourceHash, sourceSize, decodedSound);
+	LOG_DEBUG("Decoded " << sourcePath << " and added it to the audio cache");
+
+	sound.cacheFile.Close();
+	sound.format = decodedSound.format;
+	sound.sampleRate = decodedSound.sampleRate;
+	sound.decodedData = move(decodedSound.pcmData);
+	sound.pcmData = sound.decodedData.data();
+	sound.pcmSize = sound.decodedData.size();
+	return true;
+}
+
+bool AudioCache::LoadCacheFile(const string& cachePath, unsigned long long sourceHash, unsigned long long sourceSize, CachedSound& sound) const
+{
+	if (!sound.cacheFile.Open(cachePath))
+	{
+		return false;
+	}
+
+	//Anything that does not match exactly is treated as a miss and overwritten
+	AudioCacheHeader header;
+	size_t fileSize = sound.cacheFile.GetSize();
+	if (fileSize < sizeof(header))
+	{
+		sound.cacheFile.Close();
+		return false;
+	}
+	memcpy(&header, sound.cacheFile.GetData(), sizeof(header));
+
+	if (memcmp(header.magic, AudioCacheMagic, sizeof(AudioCacheMagic)) != 0 || header.version != AudioCacheVersion ||
+		header.sourceHash != sourceHash || header.sourceSize != sourceSize ||
+		header.dataOffset < sizeof(header) || header.dataOffset > fileSize || header.dataSize > fileSize - header.dataOffset)
+	{
+		sound.cacheFile.Close();
+		return false;
+	}
+
+	sound.format = header.format;
+	sound.sampleRate = header.sampleRate;
+	sound.pcmData = sound.cacheFile.GetData() + header.dataOffset;
+	sound.pcmSize = (size_t)header.dataSize;
+	sound.decodedData.clear();
+	return true;
+}
+
+void AudioCache::WriteCacheFile(const string& cachePath, unsigned long long sourceHash, unsigned long long sourceSize, const DecodedSound& decodedSound) const
+{
+	CreateDirectoryIfMissing(cacheDirectory);
+
+	AudioCacheHeader header = {};
+	memcpy(header.magic, AudioCacheMagic, sizeof(AudioCacheMagic));
+	header.version = AudioCacheVersion;
+	header.format = decodedSound.format;
+	header.sourceHash = sourceHash;
+	header.sourceSize = sourceSize;
+	header.sampleRate = decodedSound.sampleRate;
+	header.dataOffset = (sizeof(header) + AudioCacheDataAlignment - 1) / AudioCacheDataAlignment * AudioCacheDataAlignment;
+	header.dataSize = decodedSound.pcmData.size();
+
+	//Write under a temporary name first, so a crash part way through never leaves a truncated entry behind
+	string temporaryPath = cachePath + ".tmp";
+	{
+		ofstream file(temporaryPath, ios::binary | ios::trunc);
+		if (!file)
+		{
+			LOG_WARNING("Could not write the audio cache file " << temporaryPath);
+			return;
+		}
+
+		char padding[AudioCacheDataAlignment] = {};
+		file.write((const char*)&header, sizeof(header));
+		file.write(padding, header.dataOffset - sizeof(header));
+		file.write((const char*)decodedSound.pcmData.data(), decodedSound.pcmData.size());
+		if (!file)
+		{
+			LOG_WARNING("Could not write the audio cache file " << temporaryPath);
+			file.close();
+			remove(temporaryPath.c_str());
+			return;
+		}
+	}
+
+	//Replacing a file by renaming onto it fails on Windows, so clear out any stale entry first
+	remove(cachePath.c_str());
+	if (rename(temporaryPath.c_str(), cachePath.c_str()) != 0)
+	{
+		remove(temporaryPath.c_str());
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "MappedFile.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+//PCM samples in the layout alBufferData expects
+struct DecodedSound
+{
+	int format = 0; //OpenAL buffer format, such as AL_FORMAT_MONO16
+	unsigned int sampleRate = 0;
+	std::vector<uint8_t> pcmData;
+};
+
+//A sound loaded through AudioCache. pcmData points into the memory mapped cache file on a
+//cache hit, or into decodedData when the sound had to be decoded
+struct CachedSound
+{
+	int format = 0;
+	unsigned int sampleRate = 0;
+	const uint8_t* pcmData = nullptr;
+	size_t pcmSize = 0;
+
+	MappedFile cacheFile;
+	std::vector<uint8_t> decodedData;
+};
+
+//Keeps decoded sounds on disk so later launches skip decoding. Each sound is stored in its own
+//file named after a hash of the source file's contents, so editing a sound makes a new entry
+//instead of serving a stale one. The samples sit at an aligned offset and are memory mapped
+//straight into the buffer upload
+class AudioCache
+{
+public:
+	typedef std::function<bool(const std::string& sourcePath, DecodedSound& sound)> Decoder;
+
+	//decoder turns a source file into PCM data whenever the cache has no entry for it
+	AudioCache(const std::string& cacheDirectory, Decoder decoder);
+
+	//Fills sound from the cache, or decodes the source file and adds it to the cache.
+	//Returns false if the source file could not be read or decoded
+	bool Load(const std::string& sourcePath, CachedSound& sound) const;
+
+private:
+	bool LoadCacheFile(const std::string& cachePath, unsigned long long sourceHash, unsigned long long sourceSize, CachedSound& sound) const;
+	void WriteCacheFile(const std::string& cachePath, unsigned long long sourceHash, unsigned long long sourceSize, const DecodedSound& decodedSound) const;
+
+	std::string cacheDirectory;
+	Decoder decoder;
+};
@@ -0,0 +1,36 @@
+#include "AudioCommandQueue.h"
+
+using namespace std;
+
+bool AudioCommandQueue::Push(const AudioCommand& command)
+{
+	unsigned long long currentWriteIndex = writeIndex.load(memory_order_relaxed);
+	if (currentWriteIndex - readIndex.load(memory_order_acquire) >= Capacity)
+	{
+		droppedCommands.fetch_add(1, memory_order_relaxed);
+		return false;
+	}
+
+	commands[currentWriteIndex % Capacity] = command;
+	writeIndex.store(currentWriteIndex + 1, memory_order_release);
+	return true;
+}
+
+int AudioCommandQueue::Pop(AudioCommand* poppedCommands, int maxCommands)
+{
+	unsigned long long currentReadIndex = readIndex.load(memory_order_relaxed);
+	unsigned long long currentWriteIndex = writeIndex.load(memory_order_acquire);
+
+	int count = 0;
+	for (; currentReadIndex < currentWriteIndex && count < maxCommands; currentReadIndex++)
+	{
+		poppedCommands[count++] = commands[currentReadIndex % Capacity];
+	}
+	readIndex.store(currentReadIndex, memory_order_release);
+	return count;
+}
+
+unsigned long long AudioCommandQueue::TakeDroppedCommands()
+{
+	return droppedCommands.exchange(0, memory_order_relaxed);
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+
+class AudioStream;
+
+enum class AudioCommandType
+{
+	PlayTrack,
+	StartStream, //Takes ownership of stream
+	StopStream
+};
+
+struct AudioCommand
+{
+	AudioCommandType type;
+	int index; //Track for PlayTrack, stream slot for the stream commands
+	AudioStream* stream;
+};
+
+//Single producer, single consumer queue of audio commands. The game thread pushes and the audio
+//thread pops, so pushing never waits on the audio driver. A full queue drops the command
+class AudioCommandQueue
+{
+public:
+	static const int Capacity = 256;
+
+	//Returns false if the queue was full and the command was dropped
+	bool Push(const AudioCommand& command);
+
+	//Copies up to maxCommands of the oldest commands into commands and returns how many it took
+	int Pop(AudioCommand* commands, int maxCommands);
+
+	//Returns how many commands were dropped since the last call
+	unsigned long long TakeDroppedCommands();
+
+private:
+	AudioCommand commands[Capacity];
+	alignas(64) std::atomic<unsigned long long> writeIndex{ 0 };
+	alignas(64) std::atomic<unsigned long long> readIndex{ 0 };
+	std::atomic<unsigned long long> droppedCommands{ 0 };
+};
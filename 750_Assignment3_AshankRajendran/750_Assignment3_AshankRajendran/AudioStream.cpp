@@ -0,0 +1,311 @@
+#include "AudioStream.h"
+#include <AudioFile/AudioSampleConversion.h>
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+
+static const int WaveFormatPCM = 1;
+static const int WaveFormatIEEEFloat = 3;
+static const int WaveFormatExtensible = 0xFFFE;
+
+static uint32_t ReadUInt32(const uint8_t* source)
+{
+	return source[0] | (source[1] << 8) | (source[2] << 16) | ((uint32_t)source[3] << 24);
+}
+
+static uint16_t ReadUInt16(const uint8_t* source)
+{
+	return (uint16_t)(source[0] | (source[1] << 8));
+}
+
+AudioStream::AudioStream(const string& filePath, bool isLooping, bool canPlayFloat32)
+	: filePath(filePath), isLooping(isLooping), canPlayFloat32(canPlayFloat32)
+{
+	decoderThread = thread(&AudioStream::DecodeLoop, this);
+}
+
+AudioStream::~AudioStream()
+{
+	{
+		lock_guard<mutex> lock(wakeMutex);
+		isStopping.store(true, memory_order_relaxed);
+	}
+	wakeCondition.notify_one();
+	decoderThread.join();
+}
+
+const string& AudioStream::GetFilePath() const
+{
+	return filePath;
+}
+
+int AudioStream::GetNumChannels() const
+{
+	return numChannels;
+}
+
+int AudioStream::GetBitDepth() const
+{
+	return bitDepth;
+}
+
+bool AudioStream::IsFloat() const
+{
+	return isFloat;
+}
+
+unsigned int AudioStream::GetSampleRate() const
+{
+	return sampleRate;
+}
+
+bool AudioStream::PeekChunk(Chunk& chunk)
+{
+	unsigned long long currentReadIndex = readIndex.load(memory_order_relaxed);
+	if (currentReadIndex == writeIndex.load(memory_order_acquire))
+	{
+		return false;
+	}
+
+	int chunkIndex = currentReadIndex % NumberOfChunks;
+	chunk.data = chunks[chunkIndex].data();
+	chunk.size = chunkSizes[chunkIndex];
+	return true;
+}
+
+void AudioStream::PopChunk()
+{
+	readIndex.store(readIndex.load(memory_order_relaxed) + 1, memory_order_release);
+	wakeCondition.notify_one();
+}
+
+bool AudioStream::IsFinished() const
+{
+	return isEndOfFile.load(memory_order_acquire) && readIndex.load(memory_order_relaxed) == writeIndex.load(memory_order_acquire);
+}
+
+bool AudioStream::HasFailed() const
+{
+	return hasFailed.load(memory_order_acquire);
+}
+
+void AudioStream::DecodeLoop()
+{
+	if (!OpenFile())
+	{
+		hasFailed.store(true, memory_order_release);
+		readyCondition.notify_one();
+		return;
+	}
+
+	while (true)
+	{
+		{
+			unique_lock<mutex> lock(wakeMutex);
+			while (!isStopping.load(memory_order_relaxed) &&
+				writeIndex.load(memory_order_relaxed) - readIndex.load(memory_order_acquire) >= NumberOfChunks)
+			{
+				//PopChunk notifies without the lock, so wake up now and then in case that was missed
+				wakeCondition.wait_for(lock, chrono::milliseconds(ChunkMilliseconds / 2));
+			}
+			if (isStopping.load(memory_order_relaxed))
+			{
+				return;
+			}
+		}
+
+		unsigned long long currentWriteIndex = writeIndex.load(memory_order_relaxed);
+		int chunkIndex = currentWriteIndex % NumberOfChunks;
+		if (!DecodeChunk(chunks[chunkIndex], chunkSizes[chunkIndex]))
+		{
+			isEndOfFile.store(true, memory_order_release);
+			readyCondition.notify_one();
+			return;
+		}
+		writeIndex.store(currentWriteIndex + 1, memory_order_release);
+		readyCondition.notify_one();
+	}
+}
+
+void AudioStream::WaitForChunks()
+{
+	unique_lock<mutex> lock(wakeMutex);
+	while (!hasFailed.load(memory_order_acquire) && !isEndOfFile.load(memory_order_acquire) &&
+		writeIndex.load(memory_order_acquire) - readIndex.load(memory_order_relaxed) < NumberOfChunks)
+	{
+		//Notified without the lock, like PopChunk, so check again now and then
+		readyCondition.wait_for(lock, chrono::milliseconds(ChunkMilliseconds / 2));
+	}
+}
+
+//Reads the format and finds the sample data, leaving the file positioned at its start
+bool AudioStream::OpenFile()
+{
+	file.open(filePath, ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	uint8_t riffHeader[12];
+	if (!file.read((char*)riffHeader, sizeof(riffHeader)) || memcmp(riffHeader, "RIFF", 4) != 0 || memcmp(riffHeader + 8, "WAVE", 4) != 0)
+	{
+		return false;
+	}
+
+	int audioFormat = 0;
+	int numBytesPerBlock = 0;
+	bool hasFormat = false;
+	while (true)
+	{
+		uint8_t chunkHeader[8];
+		if (!file.read((char*)chunkHeader, sizeof(chunkHeader)))
+		{
+			return false;
+		}
+		uint32_t chunkSize = ReadUInt32(chunkHeader + 4);
+
+		if (memcmp(chunkHeader, "fmt ", 4) == 0)
+		{
+			uint8_t format[40] = {};
+			if (chunkSize < 16 || !file.read((char*)format, chunkSize < sizeof(format) ? chunkSize : sizeof(format)))
+			{
+				return false;
+			}
+			audioFormat = ReadUInt16(format);
+			numChannels = ReadUInt16(format + 2);
+			sampleRate = ReadUInt32(format + 4);
+			numBytesPerBlock = ReadUInt16(format + 12);
+			sourceBitDepth = ReadUInt16(format + 14);
+
+			//The real format is the start of the sub format GUID
+			if (audioFormat == WaveFormatExtensible && chunkSize >= 26)
+			{
+				audioFormat = ReadUInt16(format + 24);
+			}
+			hasFormat = true;
+			file.seekg(chunkSize > sizeof(format) ? chunkSize - sizeof(format) : 0, ios::cur);
+		}
+		else if (memcmp(chunkHeader, "data", 4) == 0)
+		{
+			dataStart = file.tellg();
+			dataSize = chunkSize;
+			break;
+		}
+		else
+		{
+			file.seekg(chunkSize, ios::cur);
+		}
+
+		//Chunks are padded to an even size
+		if (chunkSize & 1)
+		{
+			file.seekg(1, ios::cur);
+		}
+	}
+
+	if (!hasFormat || (numChannels != 1 && numChannels != 2) || sampleRate == 0)
+	{
+		return false;
+	}
+	isSourceFloat = audioFormat == WaveFormatIEEEFloat;
+	if (isSourceFloat ? sourceBitDepth != 32 : (audioFormat != WaveFormatPCM || sourceBitDepth % 8 != 0 || sourceBitDepth < 8 || sourceBitDepth > 32))
+	{
+		return false;
+	}
+	if (numBytesPerBlock != numChannels * sourceBitDepth / 8)
+	{
+		return false;
+	}
+
+	//A data chunk that claims more than the file holds is cut to what is there
+	file.seekg(0, ios::end);
+	uint64_t bytesAfterDataStart = (uint64_t)(file.tellg() - dataStart);
+	if (dataSize > bytesAfterDataStart)
+	{
+		dataSize = bytesAfterDataStart;
+	}
+	dataSize -= dataSize % numBytesPerBlock;
+	dataRemaining = dataSize;
+	file.seekg(dataStart);
+
+	//8 and 16 bit play as they are, and so does float when the driver has it. Everything else becomes 16 bit
+	needsConversion = isSourceFloat ? !canPlayFloat32 : sourceBitDepth > 16;
+	bitDepth = needsConversion ? 16 : sourceBitDepth;
+	isFloat = isSourceFloat && !needsConversion;
+
+	framesPerChunk = sampleRate * ChunkMilliseconds / 1000;
+	if (framesPerChunk == 0)
+	{
+		framesPerChunk = 1;
+	}
+	for (vector<uint8_t>& chunk : chunks)
+	{
+		chunk.resize(framesPerChunk * numChannels * bitDepth / 8);
+	}
+	if (needsConversion)
+	{
+		readBuffer.resize(framesPerChunk * numBytesPerBlock);
+		sampleBuffer.resize(framesPerChunk * numChannels);
+	}
+	return true;
+}
+
+//Reads the next chunk of samples into chunkData, going back to the start first if a looping stream
+//has reached the end. Returns false at the end of the file
+bool AudioStream::DecodeChunk(vector<uint8_t>& chunkData, size_t& chunkSize)
+{
+	if (dataRemaining == 0)
+	{
+		if (!isLooping || dataSize == 0)
+		{
+			return false;
+		}
+		file.clear();
+		file.seekg(dataStart);
+		dataRemaining = dataSize;
+	}
+
+	size_t numBytesPerSample = sourceBitDepth / 8;
+	uint64_t bytesToRead = framesPerChunk * numChannels * numBytesPerSample;
+	if (bytesToRead > dataRemaining)
+	{
+		bytesToRead = dataRemaining;
+	}
+
+	uint8_t* destination = needsConversion ? readBuffer.data() : chunkData.data();
+	file.read((char*)destination, bytesToRead);
+	size_t bytesRead = (size_t)file.gcount();
+	bytesRead -= bytesRead % (numChannels * numBytesPerSample);
+	if (bytesRead == 0)
+	{
+		return false;
+	}
+
+	//A short read means the file shrank since it was opened, so treat that as the end
+	dataRemaining = bytesRead < bytesToRead ? 0 : dataRemaining - bytesRead;
+
+	if (!needsConversion)
+	{
+		chunkSize = bytesRead;
+		return true;
+	}
+
+	size_t numValues = bytesRead / numBytesPerSample;
+	if (isSourceFloat)
+	{
+		AudioSampleConversion::float32ToSamples(readBuffer.data(), sampleBuffer.data(), numValues);
+	}
+	else if (sourceBitDepth == 24)
+	{
+		AudioSampleConversion::pcm24ToSamples(readBuffer.data(), sampleBuffer.data(), numValues);
+	}
+	else
+	{
+		AudioSampleConversion::pcm32ToSamples(readBuffer.data(), sampleBuffer.data(), numValues);
+	}
+	AudioSampleConversion::samplesToPcm16(sampleBuffer.data(), chunkData.data(), numValues);
+	chunkSize = numValues * 2;
+	return true;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Reads a .wav file a chunk at a time for streaming playback. A decoding thread reads and converts
+//chunks ahead of playback into a small ring, so however long the file is, only NumberOfChunks
+//chunks of it are ever in memory
+class AudioStream
+{
+public:
+	static const int ChunkMilliseconds = 50;
+	static const int NumberOfChunks = 4;
+
+	struct Chunk
+	{
+		const uint8_t* data;
+		size_t size;
+	};
+
+	//Starts opening and decoding filePath on the decoding thread. Samples OpenAL cannot take as they
+	//are get converted to 16 bit; float samples are passed through only if canPlayFloat32
+	AudioStream(const std::string& filePath, bool isLooping, bool canPlayFloat32);
+	~AudioStream();
+
+	AudioStream(const AudioStream&) = delete;
+	AudioStream& operator=(const AudioStream&) = delete;
+
+	const std::string& GetFilePath() const;
+
+	//Format of the chunks. Only valid once PeekChunk has returned a chunk
+	int GetNumChannels() const;
+	int GetBitDepth() const;
+	bool IsFloat() const;
+	unsigned int GetSampleRate() const;
+
+	//The functions below are for a single consumer thread
+
+	//Returns the oldest decoded chunk without removing it, or false if none is ready yet
+	bool PeekChunk(Chunk& chunk);
+
+	//Hands the chunk returned by PeekChunk back to the decoding thread
+	void PopChunk();
+
+	//Returns true once the end of the file is reached and every chunk has been taken. Never true for a looping stream
+	bool IsFinished() const;
+
+	//Returns true if the file could not be opened or is not a .wav format that can be streamed
+	bool HasFailed() const;
+
+	//Blocks until every chunk of the ring is decoded, the end of the file is reached or the stream fails.
+	//A loopback mix waits here before taking chunks, so what it mixes never depends on how far ahead the
+	//decoding thread happened to be
+	void WaitForChunks();
+
+private:
+	void DecodeLoop();
+	bool OpenFile();
+	bool DecodeChunk(std::vector<uint8_t>& chunkData, size_t& chunkSize);
+
+	std::string filePath;
+	bool isLooping;
+	bool canPlayFloat32;
+
+	std::ifstream file;
+	std::streamoff dataStart = 0;
+	uint64_t dataSize = 0;
+	uint64_t dataRemaining = 0;
+
+	//Format of the file, and of the chunks after conversion
+	int numChannels = 0;
+	int sourceBitDepth = 0;
+	bool isSourceFloat = false;
+	int bitDepth = 0;
+	bool isFloat = false;
+	unsigned int sampleRate = 0;
+	bool needsConversion = false;
+	size_t framesPerChunk = 0;
+
+	std::vector<uint8_t> chunks[NumberOfChunks];
+	size_t chunkSizes[NumberOfChunks] = {};
+	std::vector<uint8_t> readBuffer;
+	std::vector<float> sampleBuffer;
+
+	//Single producer, single consumer indices into chunks
+	alignas(64) std::atomic<unsigned long long> writeIndex{ 0 };
+	alignas(64) std::atomic<unsigned long long> readIndex{ 0 };
+
+	std::atomic<bool> isEndOfFile{ false };
+	std::atomic<bool> hasFailed{ false };
+	std::atomic<bool> isStopping{ false };
+
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	std::condition_variable readyCondition; //Notified by the decoding thread after each chunk, and when it stops
+	std::thread decoderThread;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+struct Match;
+
+//Audio output used by the game simulation. The windowed game plays through OpenAL,
+//headless runs plug in NullAudioBackend so no audio device is ever opened
+class AudioBackend
+{
+public:
+	virtual ~AudioBackend() {}
+
+	//0 -> cannon, 1 -> explosion with tank, 2 -> ground hit
+	virtual void PlayAudio(int trackIndex) = 0;
+
+	//Called after every simulation step, for backends that keep time with the simulation
+	virtual void OnSimulationTick() {}
+};
+
+class NullAudioBackend : public AudioBackend
+{
+public:
+	void PlayAudio(int trackIndex) override {}
+};
+
+//Draws one frame of the current game state. Headless runs plug in NullRenderBackend
+//so no GLFW window or OpenGL context is needed. The interpolation, from 0 to 1, is how far
+//the frame is between the last simulation step and the next one
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() {}
+
+	virtual void DrawFrame(const Match& match, float interpolation) = 0;
+};
+
+class NullRenderBackend : public RenderBackend
+{
+public:
+	void DrawFrame(const Match& match, float interpolation) override {}
+};
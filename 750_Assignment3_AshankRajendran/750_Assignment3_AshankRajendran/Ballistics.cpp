@@ -0,0 +1,201 @@
+#include "Ballistics.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+//How close to the edge of a circle, in pixels, a shell counts as on the edge rather than inside
+static const double CircleEdgeTolerance = 0.01;
+
+static const int RootBisectionSteps = 60;
+
+void GetTrajectoryPosition(const Trajectory& trajectory, double time, double& x, double& y)
+{
+	x = trajectory.startX + trajectory.velocityX * time;
+	y = trajectory.startY + trajectory.velocityY * time - 0.5 * trajectory.gravity * time * time;
+}
+
+double GetTrajectoryVelocityY(const Trajectory& trajectory, double time)
+{
+	return trajectory.velocityY - trajectory.gravity * time;
+}
+
+double SolveExitTime(const Trajectory& trajectory, double floorHeight, double screenWidth)
+{
+	//Later root of startY - floorHeight + velocityY * t - gravity * t^2 / 2 = 0, the one on the way down
+	double halfGravity = 0.5 * trajectory.gravity;
+	double heightAboveFloor = trajectory.startY - floorHeight;
+	double discriminant = trajectory.velocityY * trajectory.velocityY + 4 * halfGravity * heightAboveFloor;
+	double exitTime = discriminant < 0 ? 0 : (trajectory.velocityY + sqrt(discriminant)) / (2 * halfGravity);
+
+	if (trajectory.velocityX > 0)
+	{
+		exitTime = min(exitTime, (screenWidth - trajectory.startX) / trajectory.velocityX);
+	}
+	else if (trajectory.velocityX < 0)
+	{
+		exitTime = min(exitTime, -trajectory.startX / trajectory.velocityX);
+	}
+	return max(exitTime, 0.0);
+}
+
+//Real roots of a * t^3 + b * t^2 + c * t + d = 0 with a != 0, in no particular order. Returns how many there are
+static int SolveCubic(double a, double b, double c, double d, double roots[3])
+{
+	//Depressed cubic t = u - b / 3a, u^3 + p u + q = 0
+	double offset = b / (3 * a);
+	double p = c / a - b * b / (3 * a * a);
+	double q = 2 * b * b * b / (27 * a * a * a) - b * c / (3 * a * a) + d / a;
+
+	double halfQ = q / 2;
+	double thirdP = p / 3;
+	double discriminant = halfQ * halfQ + thirdP * thirdP * thirdP;
+
+	if (discriminant > 0)
+	{
+		double squareRoot = sqrt(discriminant);
+		roots[0] = cbrt(-halfQ + squareRoot) + cbrt(-halfQ - squareRoot) - offset;
+		return 1;
+	}
+	if (thirdP == 0)
+	{
+		roots[0] = -offset;
+		return 1;
+	}
+
+	//Three real roots, found with the trigonometric method
+	double radius = 2 * sqrt(-thirdP);
+	double angle = acos(max(-1.0, min(1.0, -halfQ / sqrt(-thirdP * thirdP * thirdP)))) / 3;
+	for (int i = 0; i < 3; i++)
+	{
+		roots[i] = radius * cos(angle - 2 * 3.14159265358979323846 * i / 3) - offset;
+	}
+	return 3;
+}
+
+double SolveCircleHitTime(const Trajectory& trajectory, double centerX, double centerY, double radius, double maxTime)
+{
+	//The shell can only be inside the circle while it is within radius of it horizontally
+	double startTime = 0;
+	double endTime = maxTime;
+	double offsetX = trajectory.startX - centerX;
+	if (trajectory.velocityX != 0)
+	{
+		double time1 = (-radius - offsetX) / trajectory.velocityX;
+		double time2 = (radius - offsetX) / trajectory.velocityX;
+		startTime = max(startTime, min(time1, time2));
+		endTime = min(endTime, max(time1, time2));
+	}
+	else if (fabs(offsetX) > radius)
+	{
+		return -1;
+	}
+	if (startTime > endTime)
+	{
+		return -1;
+	}
+
+	//...and vertically. The lowest point over the interval is at one end, the highest at the apex if it is inside
+	double x, startY, endY;
+	GetTrajectoryPosition(trajectory, startTime, x, startY);
+	GetTrajectoryPosition(trajectory, endTime, x, endY);
+	double highestY = max(startY, endY);
+	double apexTime = trajectory.gravity > 0 ? trajectory.velocityY / trajectory.gravity : -1;
+	if (apexTime > startTime && apexTime < endTime)
+	{
+		GetTrajectoryPosition(trajectory, apexTime, x, highestY);
+	}
+	if (highestY < centerY - radius || min(startY, endY) > centerY + radius)
+	{
+		return -1;
+	}
+
+	//Squared distance from the center minus radius squared is the quartic
+	//h^2 t^4 + 2 vy h t^3 + (vx^2 + vy^2 + 2 oy h) t^2 + 2 (ox vx + oy vy) t + ox^2 + oy^2 - r^2
+	//with h = -gravity / 2 and (ox, oy) the start relative to the center. It is below 0 inside the circle
+	double h = -0.5 * trajectory.gravity;
+	double vx = trajectory.velocityX;
+	double vy = trajectory.velocityY;
+	double offsetY = trajectory.startY - centerY;
+	double coefficients[5] = {
+		h * h,
+		2 * vy * h,
+		vx * vx + vy * vy + 2 * offsetY * h,
+		2 * (offsetX * vx + offsetY * vy),
+		offsetX * offsetX + offsetY * offsetY - radius * radius
+	};
+	auto distanceSquaredMinusRadiusSquared = [&coefficients](double t)
+	{
+		return (((coefficients[0] * t + coefficients[1]) * t + coefficients[2]) * t + coefficients[3]) * t + coefficients[4];
+	};
+
+	//Already inside at the start, unless it is only on the edge at launch and heading out
+	double edgeTolerance = 2 * radius * CircleEdgeTolerance;
+	double startValue = distanceSquaredMinusRadiusSquared(startTime);
+	if (startValue < -edgeTolerance)
+	{
+		return startTime;
+	}
+	if (startValue <= edgeTolerance && (startTime > 0 || coefficients[3] <= 0))
+	{
+		return startTime;
+	}
+
+	//Split the interval where the quartic turns, so each piece is monotonic and holds at most one entry
+	double splits[5];
+	int numberOfSplits = 0;
+	if (h != 0)
+	{
+		double turningPoints[3];
+		int numberOfTurningPoints = SolveCubic(4 * coefficients[0], 3 * coefficients[1], 2 * coefficients[2], coefficients[3], turningPoints);
+		for (int i = 0; i < numberOfTurningPoints; i++)
+		{
+			if (turningPoints[i] > startTime && turningPoints[i] < endTime)
+			{
+				splits[numberOfSplits++] = turningPoints[i];
+			}
+		}
+	}
+	else if (coefficients[2] > 0)
+	{
+		double turningPoint = -coefficients[3] / (2 * coefficients[2]);
+		if (turningPoint > startTime && turningPoint < endTime)
+		{
+			splits[numberOfSplits++] = turningPoint;
+		}
+	}
+	sort(splits, splits + numberOfSplits);
+	splits[numberOfSplits++] = endTime;
+
+	double pieceStart = startTime;
+	double pieceStartValue = startValue;
+	for (int i = 0; i < numberOfSplits; i++)
+	{
+		double pieceEnd = splits[i];
+		double pieceEndValue = distanceSquaredMinusRadiusSquared(pieceEnd);
+
+		//Outside at the start of the piece and inside by its end, so it enters in between
+		if (pieceStartValue > 0 && pieceEndValue <= 0)
+		{
+			double outside = pieceStart;
+			double inside = pieceEnd;
+			for (int step = 0; step < RootBisectionSteps && inside - outside > 0; step++)
+			{
+				double middle = 0.5 * (outside + inside);
+				if (distanceSquaredMinusRadiusSquared(middle) > 0)
+				{
+					outside = middle;
+				}
+				else
+				{
+					inside = middle;
+				}
+			}
+			return inside;
+		}
+
+		pieceStart = pieceEnd;
+		pieceStartValue = pieceEndValue;
+	}
+	return -1;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+//Exact flight of a shell under gravity, with no steps to tunnel between:
+//x(t) = startX + velocityX * t
+//y(t) = startY + velocityY * t - gravity * t * t / 2
+struct Trajectory
+{
+	double startX = 0;
+	double startY = 0;
+	double velocityX = 0;
+	double velocityY = 0;
+	double gravity = 0;
+};
+
+void GetTrajectoryPosition(const Trajectory& trajectory, double time, double& x, double& y);
+double GetTrajectoryVelocityY(const Trajectory& trajectory, double time);
+
+//Returns when the shell first drops below floorHeight or crosses x = 0 or x = screenWidth,
+//or 0 if it starts out past the sides. Needs gravity above 0, or a shell fired upwards never lands
+double SolveExitTime(const Trajectory& trajectory, double floorHeight, double screenWidth);
+
+//Returns the first time in [0, maxTime] the shell enters the circle, or -1 if it does not before
+//then. A shell that starts on the edge of the circle and heads outwards, like one leaving the
+//tank that fired it, does not count as inside it until it comes back
+double SolveCircleHitTime(const Trajectory& trajectory, double centerX, double centerY, double radius, double maxTime);
@@ -0,0 +1,99 @@
+#include "BatchRunner.h"
+#include "Headless.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+int RunBatchSimulation(const BatchOptions& options)
+{
+	if (options.numberOfMatches < 1 || options.tanksPerMatch < 2 || options.matchesPerTask < 1)
+	{
+		cerr << "Batch mode needs at least 1 match and 2 tanks per match" << endl;
+		return -1;
+	}
+
+	//Each match writes only its own slot, so the workers never share anything until the end
+	vector<MatchStatistics> results(options.numberOfMatches);
+
+	auto startTime = chrono::steady_clock::now();
+
+	ThreadPool threadPool(options.numberOfThreads);
+
+	for (int firstMatch = 0; firstMatch < options.numberOfMatches; firstMatch += options.matchesPerTask)
+	{
+		int lastMatch = min(firstMatch + options.matchesPerTask, options.numberOfMatches);
+
+		threadPool.Submit([&options, &results, firstMatch, lastMatch]()
+			{
+				Match match;
+				match.isDeterministic = options.isDeterministic;
+
+				unique_ptr<ShotSearch> shotSearch;
+				if (options.isSearchingShots)
+				{
+					ShotSearchOptions searchOptions = options.searchOptions;
+					searchOptions.numberOfThreads = 1;
+					shotSearch = make_unique<ShotSearch>(searchOptions);
+				}
+
+				for (int i = firstMatch; i < lastMatch; i++)
+				{
+					results[i] = PlayScriptedMatch(match, options.tanksPerMatch, options.maxTurnsPerMatch, options.seed + i, false,
+						options.isComputerAiming ? &options.aimError : nullptr, shotSearch.get());
+				}
+			});
+	}
+
+	threadPool.WaitForAll();
+
+	double elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	//Aggregate the statistics of every match
+	vector<long long> winsByTank(options.tanksPerMatch, 0);
+	long long totalTurns = 0;
+	long long totalHits = 0;
+	long long totalSteps = 0;
+	uint64_t checksum = 0;
+	int draws = 0;
+
+	for (const MatchStatistics& statistics : results)
+	{
+		if (statistics.winningTankIndex == -1)
+		{
+			draws++;
+		}
+		else
+		{
+			winsByTank[statistics.winningTankIndex]++;
+		}
+		totalTurns += statistics.turns;
+		totalHits += statistics.hits;
+		totalSteps += statistics.simulationSteps;
+		checksum = CombineChecksums(checksum, statistics.checksum);
+	}
+
+	cout << "\nBatch simulation finished on " << threadPool.GetNumberOfThreads() << " threads";
+	cout << "\nMatches: " << options.numberOfMatches << " (" << draws << " without a winner)";
+	cout << "\nTurns: " << totalTurns << ", simulation steps: " << totalSteps;
+	if (options.isDeterministic)
+	{
+		cout << "\nChecksum: " << hex << setw(16) << setfill('0') << checksum << dec << setfill(' ');
+	}
+	cout << "\nAverage turns per match: " << (double)totalTurns / options.numberOfMatches;
+	cout << "\nHits: " << totalHits << ", misses: " << totalTurns - totalHits << ", hit rate: " << (totalTurns > 0 ? 100.0 * totalHits / totalTurns : 0) << "%";
+
+	for (int i = 0; i < options.tanksPerMatch; i++)
+	{
+		cout << "\nTank " << i + 1 << " won " << winsByTank[i] << " matches (" << 100.0 * winsByTank[i] / options.numberOfMatches << "%)";
+	}
+
+	cout << "\nElapsed time: " << elapsedSeconds << " s";
+	cout << "\nMatches per second: " << options.numberOfMatches / elapsedSeconds;
+	cout << "\nTurns per second: " << totalTurns / elapsedSeconds << "\n";
+	return 0;
+}
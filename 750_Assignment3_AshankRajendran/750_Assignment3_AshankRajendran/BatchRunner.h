@@ -0,0 +1,36 @@
+#pragma once
+#include "ComputerPlayer.h"
+#include "ShotSearch.h"
+
+struct BatchOptions
+{
+	int numberOfMatches = 10000;
+	int tanksPerMatch = 4;
+	unsigned int seed = 1;
+
+	//0 threads means one per hardware thread
+	int numberOfThreads = 0;
+
+	//Matches that have not finished after this many shots are counted as draws
+	int maxTurnsPerMatch = 10000;
+
+	//Matches handed to the thread pool as a single task
+	int matchesPerTask = 16;
+
+	//Plays Match::isDeterministic matches and reports their combined checksum, which does not depend
+	//on the number of threads
+	bool isDeterministic = false;
+
+	//Has every tank aim with AimComputerPlayer, off by up to aimError, instead of shooting at random
+	bool isComputerAiming = false;
+	AimError aimError;
+
+	//Has every tank pick its shots with a ShotSearch instead, which takes precedence over isComputerAiming.
+	//Each task searches on its own thread, whatever searchOptions.numberOfThreads says
+	bool isSearchingShots = false;
+	ShotSearchOptions searchOptions;
+};
+
+//Plays independent scripted matches on every core through a work-stealing thread pool,
+//then prints the combined win and hit statistics. Returns the process exit code
+int RunBatchSimulation(const BatchOptions& options);
@@ -0,0 +1,174 @@
+#include "ComputerPlayer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+//The floating point shells are launched with Game.h's PI, so their angles are scaled to leave
+//in the direction the solver worked out
+static const double ExactPi = 3.14159265358979323846;
+
+bool ParseDifficulty(const char* name, AimError& error)
+{
+	static const char* difficultyNames[] = { "easy", "medium", "hard" };
+	static const AimError difficultyErrors[] = { EasyAimError, MediumAimError, HardAimError };
+	for (int i = 0; i < 3; i++)
+	{
+		if (strcmp(name, difficultyNames[i]) == 0)
+		{
+			error = difficultyErrors[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+int ChooseTarget(const Match& match, int shooterIndex)
+{
+	const Tank& shooter = match.allTanks[shooterIndex];
+	int nearestIndex = -1;
+	int safeIndex = -1;
+	int64_t nearestDistanceSquared = 0;
+	int64_t safeDistanceSquared = 0;
+
+	//Walk the columns outwards from the shooter. Tanks only ever move up and down, so the column index stays
+	//right, and the sideways distance to a column is as close as any tank in it can be
+	for (int offset = 0; offset < SCREENSIZE_X; offset++)
+	{
+		int64_t offsetSquared = (int64_t)offset * offset;
+		if (safeIndex != -1 && offsetSquared > safeDistanceSquared)
+		{
+			break;
+		}
+
+		for (int side = 0; side < (offset == 0 ? 1 : 2); side++)
+		{
+			int column = shooter.xCoordinate + (side == 0 ? offset : -offset);
+			if (column < 0 || column >= SCREENSIZE_X)
+			{
+				continue;
+			}
+
+			for (int j = match.columnTankStart[column]; j < match.columnTankStart[column + 1]; j++)
+			{
+				int i = match.tanksByColumn[j];
+				const Tank& tank = match.allTanks[i];
+				if (i == shooterIndex || !tank.isAlive)
+				{
+					continue;
+				}
+
+				int64_t distanceX = tank.xCoordinate - shooter.xCoordinate;
+				int64_t distanceY = tank.yCoordinate - shooter.yCoordinate;
+				int64_t distanceSquared = distanceX * distanceX + distanceY * distanceY;
+				if (nearestIndex == -1 || distanceSquared < nearestDistanceSquared)
+				{
+					nearestIndex = i;
+					nearestDistanceSquared = distanceSquared;
+				}
+
+				//A shell landing on the near side of the target is this far from the shooter's center
+				int64_t clearance = shooter.tankSize + tank.tankSize + BlastRadius;
+				if (distanceSquared >= clearance * clearance && (safeIndex == -1 || distanceSquared < safeDistanceSquared))
+				{
+					safeIndex = i;
+					safeDistanceSquared = distanceSquared;
+				}
+			}
+		}
+	}
+	return safeIndex != -1 ? safeIndex : nearestIndex;
+}
+
+//Works out the angle, in thousandths of a degree facing right, and the power, in thousandths, that land a
+//shell from a tank of the given radius on the point distance pixels to its right and height above its
+//center. Returns false if no shot within the tank's limits does, with the closest one it can make
+static bool SolveAim(int distance, int height, int radius, int& angle, int& power)
+{
+	const int minAngle = ToMillidegrees(TankMinAngle);
+	const int maxAngle = 90000;
+	const Fixed gravity = ToFixed(ACCELERATION_DUE_TO_GRAVITY);
+	const int64_t minSpeedSquared = (int64_t)(TankMinPower * TankMinPower) << LaunchSpeedFractionBits;
+	const int64_t maxSpeedSquared = (int64_t)(TankMaxPower * TankMaxPower) << LaunchSpeedFractionBits;
+
+	//The slowest shot through a point leaves halfway between straight up and the line to the point
+	angle = min(max((maxAngle + GetFixedAngle(distance, height)) / 2, minAngle), maxAngle);
+	int64_t speedSquared = GetFixedLaunchSpeedSquared(distance, height, radius, angle, gravity);
+	if (speedSquared == -1 || speedSquared > maxSpeedSquared)
+	{
+		power = (int)(TankMaxPower * 1000);
+		return false;
+	}
+
+	//Too close for the lowest power, so lob it higher. The speed needed only grows from here to
+	//straight up, so bisect for the lowest angle the lowest power reaches at
+	if (speedSquared < minSpeedSquared)
+	{
+		int low = angle;
+		int high = maxAngle;
+		while (high - low > 1)
+		{
+			int middle = (low + high) / 2;
+			int64_t middleSpeedSquared = GetFixedLaunchSpeedSquared(distance, height, radius, middle, gravity);
+			if (middleSpeedSquared != -1 && middleSpeedSquared < minSpeedSquared)
+			{
+				low = middle;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		angle = high;
+		speedSquared = minSpeedSquared;
+	}
+
+	//Thousandths of the square root of speedSquared / 2^LaunchSpeedFractionBits
+	power = (int)IntegerSquareRoot(speedSquared * 1000000 >> LaunchSpeedFractionBits);
+	power = min(max(power, (int)(TankMinPower * 1000)), (int)(TankMaxPower * 1000));
+	return true;
+}
+
+//Random whole number from -spread to spread. Drawn straight from the generator, as the distributions
+//differ between standard libraries
+static int GetRandomError(Match& match, int spread)
+{
+	return spread > 0 ? (int)(match.randomGenerator() % (2 * (unsigned int)spread + 1)) - spread : 0;
+}
+
+bool AimAt(Match& match, int targetIndex, const AimError& error)
+{
+	Tank& shooter = match.allTanks[match.currentPlayer];
+	const Tank& target = match.allTanks[targetIndex];
+
+	int distanceX = target.xCoordinate - shooter.xCoordinate;
+	int angle, power;
+	bool isReachable = SolveAim(abs(distanceX), target.yCoordinate - shooter.yCoordinate, shooter.tankSize, angle, power);
+
+	angle += GetRandomError(match, ToMillidegrees(error.angleDegrees));
+	power += GetRandomError(match, (int)((int64_t)power * llround(error.powerFraction * 1000) / 1000));
+	if (distanceX < 0)
+	{
+		angle = 180000 - angle;
+	}
+
+	float angleDegrees = match.isDeterministic ? angle / 1000.0f : (float)(angle / 1000.0 * ExactPi / PI);
+	shooter.angle = min(max(angleDegrees, TankMinAngle), TankMaxAngle);
+	shooter.power = min(max(power / 1000.0f, TankMinPower), TankMaxPower);
+
+	LOG_DEBUG("Tank " << match.currentPlayer + 1 << " aims at Tank " << targetIndex + 1 << (isReachable ? "" : ", which is out of reach,")
+		<< " with angle " << shooter.angle << " and power " << shooter.power);
+	return isReachable;
+}
+
+void AimComputerPlayer(Match& match, const AimError& error)
+{
+	int targetIndex = ChooseTarget(match, match.currentPlayer);
+	if (targetIndex != -1)
+	{
+		AimAt(match, targetIndex, error);
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Game.h"
+
+//How far off a computer-controlled tank's shots are. The solved angle is moved by up to angleDegrees
+//either way and the solved power by up to powerFraction of it, picked at random for every shot
+struct AimError
+{
+	float angleDegrees = 0;
+	float powerFraction = 0;
+};
+
+const AimError EasyAimError = { 8, 0.1f };
+const AimError MediumAimError = { 3, 0.04f };
+const AimError HardAimError = { 0, 0 };
+
+//Parses "easy", "medium" or "hard". Returns false if the name is not a difficulty
+bool ParseDifficulty(const char* name, AimError& error);
+
+//Returns the nearest living tank far enough from the shooter that the blast of a shell landing on it
+//cannot reach back, or the nearest living tank at all if none is. -1 if the shooter is the only one left
+int ChooseTarget(const Match& match, int shooterIndex);
+
+//Sets the current player's angle and power to land a shell on the target, give or take the error, without
+//firing. The shot is solved for open ground, ignoring the terrain and tanks in between, with integer math
+//only so deterministic matches stay deterministic. Returns false if the target is out of reach, in which
+//case the tank gets as close as it can
+bool AimAt(Match& match, int targetIndex, const AimError& error);
+
+//Chooses a target for the current player and aims at it. Call FireProjectile next to take the shot
+void AimComputerPlayer(Match& match, const AimError& error);
@@ -0,0 +1,315 @@
+#include "FixedBallistics.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+//atan(2^-i) in degrees with 20 fraction bits, and the CORDIC gain with 30, worked out ahead of time
+//so no floating point math is involved
+static const int64_t CordicAngles[] = {
+	47185920, 27855475, 14718068, 7471121, 3750058, 1876857, 938658, 469357, 234682, 117342, 58671, 29335, 14668, 7334,
+	3667, 1833, 917, 458, 229, 115, 57, 29, 14, 7, 4, 2, 1
+};
+static const int64_t CordicGain = 652032874;
+static const int CordicAngleFractionBits = 20;
+static const int SineFractionBits = 30;
+
+//Rounds to nearest, halves away from zero
+static int64_t DivideRounded(int64_t numerator, int64_t denominator)
+{
+	if (denominator < 0)
+	{
+		numerator = -numerator;
+		denominator = -denominator;
+	}
+	return numerator >= 0 ? (numerator + denominator / 2) / denominator : -((-numerator + denominator / 2) / denominator);
+}
+
+static int64_t ShiftRounded(int64_t value, int bits)
+{
+	return (value + ((int64_t)1 << (bits - 1))) >> bits;
+}
+
+//Largest n with n * denominator <= numerator, for denominator above 0
+static int64_t DivideFloor(int64_t numerator, int64_t denominator)
+{
+	int64_t quotient = numerator / denominator;
+	return quotient * denominator > numerator ? quotient - 1 : quotient;
+}
+
+Fixed ToFixed(double value)
+{
+	return (Fixed)llround(value * FixedOne);
+}
+
+double FromFixed(Fixed value)
+{
+	return (double)value / FixedOne;
+}
+
+Fixed ToFixedThousandths(double value)
+{
+	return DivideRounded(llround(value * 1000) * FixedOne, 1000);
+}
+
+int64_t IntegerSquareRoot(int64_t value)
+{
+	//The floating point root is only a first guess, corrected to the exact answer
+	int64_t root = (int64_t)sqrt((double)value);
+	while (root > 0 && root * root > value)
+	{
+		root--;
+	}
+	while ((root + 1) * (root + 1) <= value)
+	{
+		root++;
+	}
+	return root;
+}
+
+int ToMillidegrees(double degrees)
+{
+	return (int)llround(degrees * 1000);
+}
+
+void GetFixedSineCosine(int angleMillidegrees, int64_t& sine, int64_t& cosine)
+{
+	//Bring the angle into [-180, 180) degrees
+	int angle = angleMillidegrees % 360000;
+	if (angle >= 180000)
+	{
+		angle -= 360000;
+	}
+	else if (angle < -180000)
+	{
+		angle += 360000;
+	}
+
+	//CORDIC only converges up to about 99 degrees either side, so turn by a quarter first if needed
+	int quarterTurns = 0;
+	if (angle > 90000)
+	{
+		angle -= 90000;
+		quarterTurns = 1;
+	}
+	else if (angle < -90000)
+	{
+		angle += 90000;
+		quarterTurns = -1;
+	}
+
+	int64_t remaining = DivideRounded((int64_t)angle << CordicAngleFractionBits, 1000);
+	int64_t x = CordicGain;
+	int64_t y = 0;
+	for (int i = 0; i < (int)(sizeof(CordicAngles) / sizeof(CordicAngles[0])); i++)
+	{
+		int64_t shiftedX = x >> i;
+		int64_t shiftedY = y >> i;
+		if (remaining >= 0)
+		{
+			x -= shiftedY;
+			y += shiftedX;
+			remaining -= CordicAngles[i];
+		}
+		else
+		{
+			x += shiftedY;
+			y -= shiftedX;
+			remaining += CordicAngles[i];
+		}
+	}
+
+	if (quarterTurns == 1)
+	{
+		sine = x;
+		cosine = -y;
+	}
+	else if (quarterTurns == -1)
+	{
+		sine = -x;
+		cosine = y;
+	}
+	else
+	{
+		sine = y;
+		cosine = x;
+	}
+}
+
+int GetFixedAngle(int64_t x, int64_t y)
+{
+	//Turn the point onto the x axis a CORDIC step at a time, adding up the turns. Scaled up first so the
+	//shifts keep enough bits
+	x *= (int64_t)1 << 24;
+	y *= (int64_t)1 << 24;
+	int64_t angle = 0;
+	for (int i = 0; i < (int)(sizeof(CordicAngles) / sizeof(CordicAngles[0])); i++)
+	{
+		int64_t shiftedX = x >> i;
+		int64_t shiftedY = y >> i;
+		if (y > 0)
+		{
+			x += shiftedY;
+			y -= shiftedX;
+			angle += CordicAngles[i];
+		}
+		else if (y < 0)
+		{
+			x -= shiftedY;
+			y += shiftedX;
+			angle -= CordicAngles[i];
+		}
+	}
+	return (int)DivideRounded(angle * 1000, (int64_t)1 << CordicAngleFractionBits);
+}
+
+int64_t GetFixedLaunchSpeedSquared(int distance, int height, int radius, int angleMillidegrees, Fixed gravity)
+{
+	int64_t sine, cosine;
+	GetFixedSineCosine(angleMillidegrees, sine, cosine);
+
+	//With the shell starting radius along the line of fire, speed^2 = gravity * across^2 / (2 * cosine * above),
+	//across being how far it has to go sideways and above how far the line of fire passes over the point
+	//at that distance, times cosine. All three are in units of 2^-SineFractionBits and the units cancel.
+	//across and above are cut down by 16 bits and divided out before the cosine, to keep the products in range
+	int64_t across = ((int64_t)distance << SineFractionBits) - radius * cosine;
+	int64_t above = distance * sine - height * cosine;
+	int64_t shortAcross = across >> 16;
+	int64_t shortAbove = above >> 16;
+	if (shortAcross <= 0 || shortAbove <= 0 || cosine <= 0)
+	{
+		return -1;
+	}
+
+	//Capped at far beyond any speed a tank can fire at
+	int64_t shortGravity = ShiftRounded(gravity, FixedFractionBits - LaunchSpeedFractionBits);
+	int64_t partial = min<int64_t>(shortGravity * shortAcross * shortAcross / shortAbove, (int64_t)1 << 46);
+	return (partial << 15) / cosine;
+}
+
+FixedTrajectory MakeFixedTrajectory(Fixed centerX, Fixed centerY, Fixed radius, int angleMillidegrees, Fixed power, Fixed gravity, int ticksPerSecond)
+{
+	int64_t sine, cosine;
+	GetFixedSineCosine(angleMillidegrees, sine, cosine);
+
+	FixedTrajectory trajectory;
+	trajectory.startX = centerX + ShiftRounded(radius * cosine, SineFractionBits);
+	trajectory.startY = centerY + ShiftRounded(radius * sine, SineFractionBits);
+	trajectory.velocityX = DivideRounded(ShiftRounded(power * cosine, SineFractionBits), ticksPerSecond);
+	trajectory.velocityY = DivideRounded(ShiftRounded(power * sine, SineFractionBits), ticksPerSecond);
+	trajectory.halfGravity = DivideRounded(gravity, 2 * (int64_t)ticksPerSecond * ticksPerSecond);
+	return trajectory;
+}
+
+void GetFixedPosition(const FixedTrajectory& trajectory, long long tick, Fixed& x, Fixed& y)
+{
+	x = trajectory.startX + trajectory.velocityX * tick;
+	y = trajectory.startY + trajectory.velocityY * tick - trajectory.halfGravity * tick * tick;
+}
+
+Trajectory ToTrajectory(const FixedTrajectory& trajectory, int ticksPerSecond)
+{
+	Trajectory floatingTrajectory;
+	floatingTrajectory.startX = FromFixed(trajectory.startX);
+	floatingTrajectory.startY = FromFixed(trajectory.startY);
+	floatingTrajectory.velocityX = FromFixed(trajectory.velocityX) * ticksPerSecond;
+	floatingTrajectory.velocityY = FromFixed(trajectory.velocityY) * ticksPerSecond;
+	floatingTrajectory.gravity = FromFixed(2 * trajectory.halfGravity) * ticksPerSecond * ticksPerSecond;
+	return floatingTrajectory;
+}
+
+long long SolveFixedTickBelow(const FixedTrajectory& trajectory, long long fromTick, long long untilTick, Fixed height)
+{
+	if (fromTick > untilTick)
+	{
+		return -1;
+	}
+
+	//The flight is a downward parabola, so the ticks at or above height are one unbroken run. If the shell
+	//is above height at both ends it is above it throughout, otherwise it drops below once
+	Fixed x, y;
+	GetFixedPosition(trajectory, fromTick, x, y);
+	if (y < height)
+	{
+		return fromTick;
+	}
+	GetFixedPosition(trajectory, untilTick, x, y);
+	if (y >= height)
+	{
+		return -1;
+	}
+
+	long long above = fromTick;
+	long long below = untilTick;
+	while (below - above > 1)
+	{
+		long long middle = above + (below - above) / 2;
+		GetFixedPosition(trajectory, middle, x, y);
+		if (y < height)
+		{
+			below = middle;
+		}
+		else
+		{
+			above = middle;
+		}
+	}
+	return below;
+}
+
+long long GetFixedLastTickBetween(const FixedTrajectory& trajectory, long long fromTick, Fixed lowX, Fixed highX)
+{
+	long long lastTick = MaxFixedFlightTicks;
+	if (trajectory.velocityX > 0)
+	{
+		lastTick = DivideFloor(highX - trajectory.startX, trajectory.velocityX);
+	}
+	else if (trajectory.velocityX < 0)
+	{
+		lastTick = DivideFloor(trajectory.startX - lowX, -trajectory.velocityX);
+	}
+	return min<long long>(max<long long>(lastTick, fromTick), MaxFixedFlightTicks);
+}
+
+long long SolveFixedCircleHitTick(const FixedTrajectory& trajectory, long long fromTick, long long untilTick, Fixed centerX, Fixed centerY, Fixed radius)
+{
+	//Only the ticks where the shell is less than radius away horizontally need looking at
+	long long firstTick = fromTick + 1;
+	long long lastTick = untilTick - 1;
+	Fixed offsetX = trajectory.startX - centerX;
+	if (trajectory.velocityX > 0)
+	{
+		firstTick = max<long long>(firstTick, DivideFloor(-radius - offsetX, trajectory.velocityX) + 1);
+		lastTick = min<long long>(lastTick, -DivideFloor(offsetX - radius, trajectory.velocityX) - 1);
+	}
+	else if (trajectory.velocityX < 0)
+	{
+		firstTick = max<long long>(firstTick, DivideFloor(offsetX - radius, -trajectory.velocityX) + 1);
+		lastTick = min<long long>(lastTick, -DivideFloor(-radius - offsetX, -trajectory.velocityX) - 1);
+	}
+	else if (offsetX <= -radius || offsetX >= radius)
+	{
+		return -1;
+	}
+
+	//Compare squared distances with 16 fraction bits, which keeps them in range for any circle that fits on screen
+	int64_t radiusSquared = (radius >> 8) * (radius >> 8);
+	for (long long tick = firstTick; tick <= lastTick; tick++)
+	{
+		Fixed x, y;
+		GetFixedPosition(trajectory, tick, x, y);
+		Fixed offsetY = y - centerY;
+		if (offsetY <= -radius || offsetY >= radius)
+		{
+			continue;
+		}
+
+		int64_t distanceX = (x - centerX) >> 8;
+		int64_t distanceY = offsetY >> 8;
+		if (distanceX * distanceX + distanceY * distanceY < radiusSquared)
+		{
+			return tick;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "Ballistics.h"
+#include <cstdint>
+
+//Fixed point number with FixedFractionBits fraction bits. Everything in this file is integer
+//arithmetic, so the same inputs give bit for bit the same results with any compiler, flags or CPU
+typedef int64_t Fixed;
+
+const int FixedFractionBits = 24;
+const Fixed FixedOne = (Fixed)1 << FixedFractionBits;
+
+//Longest flight the solvers look at, in ticks. Keeps every product below in range
+const long long MaxFixedFlightTicks = 1 << 24;
+
+//Nearest fixed point value. Exact for the float inputs the game uses, as doubles hold them with room to spare
+Fixed ToFixed(double value);
+double FromFixed(Fixed value);
+
+//Fixed point value of the nearest whole number of thousandths. Inputs a float rounding error or two
+//either side of the same thousandth all give the same result
+Fixed ToFixedThousandths(double value);
+
+//Largest whole number whose square is at most value, for value of 0 or more
+int64_t IntegerSquareRoot(int64_t value);
+
+//Nearest whole number of thousandths of a degree
+int ToMillidegrees(double degrees);
+
+//Sine and cosine of an angle in thousandths of a degree, with 30 fraction bits, worked out with CORDIC
+void GetFixedSineCosine(int angleMillidegrees, int64_t& sine, int64_t& cosine);
+
+//Angle of the point (x, y) from the origin, in thousandths of a degree from -90000 to 90000, worked out
+//with CORDIC. x must be 0 or more and neither can be more than 2^32 away from 0
+int GetFixedAngle(int64_t x, int64_t y);
+
+//Square of the speed, in pixels per second with LaunchSpeedFractionBits fraction bits, at which a shell fired at
+//angleMillidegrees from the edge of a circle of the given radius passes through the point distance pixels to the
+//right of its center and height pixels above it, under gravity in pixels per second squared. -1 if there is no such
+//speed, as the point is behind where the shell starts or not above its line of fire. Speeds far beyond any tank's
+//come out capped. distance up to a few thousand pixels
+const int LaunchSpeedFractionBits = 8;
+int64_t GetFixedLaunchSpeedSquared(int distance, int height, int radius, int angleMillidegrees, Fixed gravity);
+
+//Flight of a shell in whole simulation ticks, with positions in pixels and velocities per tick:
+//x(n) = startX + velocityX * n
+//y(n) = startY + velocityY * n - halfGravity * n * n
+//Every tick lands exactly on that curve, however many ticks are skipped
+struct FixedTrajectory
+{
+	Fixed startX = 0;
+	Fixed startY = 0;
+	Fixed velocityX = 0;
+	Fixed velocityY = 0;
+	Fixed halfGravity = 0;
+};
+
+//Shell fired from the edge of a circle around (centerX, centerY), at power pixels per second, under
+//gravity in pixels per second squared, with ticksPerSecond ticks to the second
+FixedTrajectory MakeFixedTrajectory(Fixed centerX, Fixed centerY, Fixed radius, int angleMillidegrees, Fixed power, Fixed gravity, int ticksPerSecond);
+
+void GetFixedPosition(const FixedTrajectory& trajectory, long long tick, Fixed& x, Fixed& y);
+
+//The same flight with time in seconds, for the floating point queries. Close to the fixed one, not exact
+Trajectory ToTrajectory(const FixedTrajectory& trajectory, int ticksPerSecond);
+
+//Returns the first tick from fromTick to untilTick at which the shell is below height, or -1 if there is none
+long long SolveFixedTickBelow(const FixedTrajectory& trajectory, long long fromTick, long long untilTick, Fixed height);
+
+//Returns the last tick at which the shell is still between lowX and highX, given that it is at fromTick.
+//Never more than MaxFixedFlightTicks
+long long GetFixedLastTickBetween(const FixedTrajectory& trajectory, long long fromTick, Fixed lowX, Fixed highX);
+
+//Returns the first tick after fromTick and before untilTick at which the shell is strictly inside the
+//circle, or -1 if there is none. Only ticks are tested, not the path in between
+long long SolveFixedCircleHitTick(const FixedTrajectory& trajectory, long long fromTick, long long untilTick, Fixed centerX, Fixed centerY, Fixed radius);
@@ -0,0 +1,60 @@
+#include "GLFunctions.h"
+#include <cstdio>
+
+GLFunctions glFunctions;
+
+template <typename FunctionPointer>
+static bool Load(FunctionPointer& function, const char* name)
+{
+	function = reinterpret_cast<FunctionPointer>(glfwGetProcAddress(name));
+	return function != nullptr;
+}
+
+//Returns the version of the current context as major * 10 + minor, e.g. 33 for 3.3
+static int GetGLVersion()
+{
+	const char* versionString = (const char*)glGetString(GL_VERSION);
+	int major = 0;
+	int minor = 0;
+	if (versionString == nullptr || sscanf(versionString, "%d.%d", &major, &minor) != 2)
+	{
+		return 0;
+	}
+	return major * 10 + minor;
+}
+
+void LoadGLFunctions()
+{
+	GLFunctions& gl = glFunctions;
+	int version = GetGLVersion();
+
+	//Some drivers hand out pointers for functions the context cannot use, so the version is checked too
+	bool found = Load(gl.GenBuffers, "glGenBuffers");
+	found &= Load(gl.DeleteBuffers, "glDeleteBuffers");
+	found &= Load(gl.BindBuffer, "glBindBuffer");
+	found &= Load(gl.BufferData, "glBufferData");
+	found &= Load(gl.BufferSubData, "glBufferSubData");
+	gl.hasBufferObjects = found && version >= 15;
+
+	found = Load(gl.CreateShader, "glCreateShader");
+	found &= Load(gl.ShaderSource, "glShaderSource");
+	found &= Load(gl.CompileShader, "glCompileShader");
+	found &= Load(gl.GetShaderiv, "glGetShaderiv");
+	found &= Load(gl.GetShaderInfoLog, "glGetShaderInfoLog");
+	found &= Load(gl.DeleteShader, "glDeleteShader");
+	found &= Load(gl.CreateProgram, "glCreateProgram");
+	found &= Load(gl.AttachShader, "glAttachShader");
+	found &= Load(gl.BindAttribLocation, "glBindAttribLocation");
+	found &= Load(gl.LinkProgram, "glLinkProgram");
+	found &= Load(gl.GetProgramiv, "glGetProgramiv");
+	found &= Load(gl.GetProgramInfoLog, "glGetProgramInfoLog");
+	found &= Load(gl.UseProgram, "glUseProgram");
+	found &= Load(gl.EnableVertexAttribArray, "glEnableVertexAttribArray");
+	found &= Load(gl.DisableVertexAttribArray, "glDisableVertexAttribArray");
+	found &= Load(gl.VertexAttribPointer, "glVertexAttribPointer");
+	gl.hasShaders = found && gl.hasBufferObjects && version >= 20;
+
+	found = Load(gl.DrawArraysInstanced, "glDrawArraysInstanced");
+	found &= Load(gl.VertexAttribDivisor, "glVertexAttribDivisor");
+	gl.hasInstancing = found && gl.hasShaders && version >= 33;
+}
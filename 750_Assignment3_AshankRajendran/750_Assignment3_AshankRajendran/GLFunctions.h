@@ -0,0 +1,73 @@
+#pragma once
+#include <GLFW/glfw3.h>
+#include <cstddef>
+
+//opengl32.lib only exports the OpenGL 1.1 API. Everything newer is looked up at runtime
+//through glfwGetProcAddress once a context is current
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+
+struct GLFunctions
+{
+	//OpenGL 1.5 buffer objects
+	void (APIENTRY* GenBuffers)(GLsizei count, GLuint* buffers) = nullptr;
+	void (APIENTRY* DeleteBuffers)(GLsizei count, const GLuint* buffers) = nullptr;
+	void (APIENTRY* BindBuffer)(GLenum target, GLuint buffer) = nullptr;
+	void (APIENTRY* BufferData)(GLenum target, std::ptrdiff_t size, const void* data, GLenum usage) = nullptr;
+	void (APIENTRY* BufferSubData)(GLenum target, std::ptrdiff_t offset, std::ptrdiff_t size, const void* data) = nullptr;
+
+	//OpenGL 2.0 shaders and generic vertex attributes
+	GLuint(APIENTRY* CreateShader)(GLenum type) = nullptr;
+	void (APIENTRY* ShaderSource)(GLuint shader, GLsizei count, const char* const* source, const GLint* length) = nullptr;
+	void (APIENTRY* CompileShader)(GLuint shader) = nullptr;
+	void (APIENTRY* GetShaderiv)(GLuint shader, GLenum name, GLint* value) = nullptr;
+	void (APIENTRY* GetShaderInfoLog)(GLuint shader, GLsizei bufferSize, GLsizei* length, char* infoLog) = nullptr;
+	void (APIENTRY* DeleteShader)(GLuint shader) = nullptr;
+	GLuint(APIENTRY* CreateProgram)() = nullptr;
+	void (APIENTRY* AttachShader)(GLuint program, GLuint shader) = nullptr;
+	void (APIENTRY* BindAttribLocation)(GLuint program, GLuint index, const char* name) = nullptr;
+	void (APIENTRY* LinkProgram)(GLuint program) = nullptr;
+	void (APIENTRY* GetProgramiv)(GLuint program, GLenum name, GLint* value) = nullptr;
+	void (APIENTRY* GetProgramInfoLog)(GLuint program, GLsizei bufferSize, GLsizei* length, char* infoLog) = nullptr;
+	void (APIENTRY* UseProgram)(GLuint program) = nullptr;
+	void (APIENTRY* EnableVertexAttribArray)(GLuint index) = nullptr;
+	void (APIENTRY* DisableVertexAttribArray)(GLuint index) = nullptr;
+	void (APIENTRY* VertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) = nullptr;
+
+	//OpenGL 3.3 instancing
+	void (APIENTRY* DrawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) = nullptr;
+	void (APIENTRY* VertexAttribDivisor)(GLuint index, GLuint divisor) = nullptr;
+
+	//Which of the groups above were found in full
+	bool hasBufferObjects = false;
+	bool hasShaders = false;
+	bool hasInstancing = false;
+};
+
+extern GLFunctions glFunctions;
+
+//Looks up the functions for the context current on this thread and fills in glFunctions
+void LoadGLFunctions();
@@ -0,0 +1,675 @@
+#include "Game.h"
+#include "Logger.h"
+#include <cmath>
+
+using namespace std;
+
+// Convert Game Coordinates to OpenGL's Coordinate system
+float NormalizeCoordinates_X(float x)
+{
+	return (x / SCREENSIZE_X) * 2 - 1;
+}
+
+float NormalizeCoordinates_Y(float y)
+{
+	return (y / SCREENSIZE_Y) * 2 - 1;
+}
+
+void PlayAudio(Match& match, int trackIndex)
+{
+	//0->cannon
+	//1->explosion
+	//2->ground hit
+	if (match.audioBackend != nullptr)
+	{
+		match.audioBackend->PlayAudio(trackIndex);
+	}
+}
+
+static uint64_t MixChecksum(uint64_t checksum, int64_t value)
+{
+	uint64_t mixed = (checksum ^ (uint64_t)value) + 0x9E3779B97F4A7C15ull;
+	mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+	mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+	return mixed ^ (mixed >> 31);
+}
+
+//Game time at the start of a step, so deterministic impacts sort the same way as the others
+static double GetTickTime(long long tick)
+{
+	return tick * (double)SimulationTimeStep;
+}
+
+void SpawnTanks(Match& match, int tankCount)
+{
+	match.numberOfTanks = tankCount;
+	match.deathCount = 0;
+	match.currentPlayer = 0;
+	match.isShooting = false;
+	match.isTankPoweringUp = false;
+	match.projectiles.Clear();
+	match.projectileClock = 0;
+	match.projectileTick = 0;
+	match.checksum = 0;
+	match.shotsFired = 0;
+	match.hitCount = 0;
+
+	match.terrain.Reset(SCREENSIZE_X, TerrainStartHeight);
+	match.allTanks.assign(tankCount, Tank());
+	match.tankStore.Reset(tankCount, SCREENSIZE_X, SCREENSIZE_Y);
+	match.tanksInReach.resize(tankCount);
+
+	//Spawn all tanks with random details
+	for (int i = 0; i < match.numberOfTanks; i++)
+	{
+		int newRandomXPos = match.randomGenerator() % SCREENSIZE_X; //Random tank x coordinate
+
+		int newRandomYPos = (int)match.terrain.GetHeight(newRandomXPos); //Tank sits on the ground
+		int randomTankSize = 10 + match.randomGenerator() % 21; //Random Tank size from 10 to 20 pixels
+
+		match.allTanks[i] = { newRandomXPos, newRandomYPos, randomTankSize };
+		match.tankStore.SetTank(i, (float)newRandomXPos, (float)newRandomYPos, (float)randomTankSize);
+
+		LOG_INFO("Tank " << i + 1 << " of size " << randomTankSize << " pixels, spawned at coordinates (" << newRandomXPos << ", " << newRandomYPos << ").");
+	}
+
+	//Counting sort of the tanks by column
+	match.columnTankStart.assign(SCREENSIZE_X + 1, 0);
+	for (const Tank& tank : match.allTanks)
+	{
+		match.columnTankStart[tank.xCoordinate + 1]++;
+	}
+	for (int column = 0; column < SCREENSIZE_X; column++)
+	{
+		match.columnTankStart[column + 1] += match.columnTankStart[column];
+	}
+	match.tanksByColumn.resize(tankCount);
+	vector<int> nextSlot(match.columnTankStart.begin(), match.columnTankStart.end() - 1);
+	for (int i = 0; i < tankCount; i++)
+	{
+		match.tanksByColumn[nextSlot[match.allTanks[i].xCoordinate]++] = i;
+	}
+
+	if (match.isDeterministic)
+	{
+		match.checksum = MixChecksum(match.checksum, ToFixed(TerrainStartHeight));
+		for (const Tank& tank : match.allTanks)
+		{
+			match.checksum = MixChecksum(match.checksum, tank.xCoordinate);
+			match.checksum = MixChecksum(match.checksum, tank.yCoordinate);
+			match.checksum = MixChecksum(match.checksum, tank.tankSize);
+		}
+	}
+}
+
+//Works out which tank, if any, a shell on the trajectory hits, and how long its flight lasts. The tank
+//queries go through tankStore, with tanksInReach as scratch space
+static double SolveFlight(const Match& match, TankStore& tankStore, int* tanksInReach, const Trajectory& trajectory, int& targetIndex)
+{
+	//The flight ends at whichever comes first: leaving the screen, hitting the ground or hitting a tank
+	double flightTime = match.terrain.SolveExitTime(trajectory);
+	targetIndex = -1;
+
+	//Only the tanks the shell comes close to need the exact test
+	int numberInReach = tankStore.FindTanksInReach(trajectory, flightTime, tanksInReach);
+
+	for (int j = 0; j < numberInReach; j++)
+	{
+		int i = tanksInReach[j];
+		const Tank& tank = match.allTanks[i];
+
+		double hitTime = SolveCircleHitTime(trajectory, tank.xCoordinate, tank.yCoordinate, tank.tankSize, flightTime);
+		if (hitTime >= 0 && (targetIndex == -1 || hitTime < flightTime))
+		{
+			flightTime = hitTime;
+			targetIndex = i;
+		}
+	}
+	return flightTime;
+}
+
+//Deterministic version of SolveFlight, which looks for the impact after flight tick fromTick and returns the
+//flight's length in ticks
+static long long SolveFixedFlight(const Match& match, TankStore& tankStore, int* tanksInReach, const FixedTrajectory& trajectory, long long fromTick, int& targetIndex)
+{
+	long long flightTicks = match.terrain.SolveFixedExitTick(trajectory, fromTick);
+	targetIndex = -1;
+
+	//The floating point query only narrows down the tanks to test. Its margin is far wider than the
+	//gap between the two flights, so it never leaves out a tank the exact test would hit
+	Trajectory approximateTrajectory = ToTrajectory(trajectory, FixedTicksPerSecond);
+	int numberInReach = tankStore.FindTanksInReach(approximateTrajectory, (double)flightTicks / FixedTicksPerSecond, tanksInReach);
+
+	for (int j = 0; j < numberInReach; j++)
+	{
+		int i = tanksInReach[j];
+		const Tank& tank = match.allTanks[i];
+
+		//A tank hit on the step the shell leaves counts, and a tie goes to the lower index
+		long long hitTick = SolveFixedCircleHitTick(trajectory, fromTick, flightTicks + 1, ToFixed(tank.xCoordinate), ToFixed(tank.yCoordinate), ToFixed(tank.tankSize));
+		if (hitTick != -1 && (hitTick < flightTicks || targetIndex == -1 || i < targetIndex))
+		{
+			flightTicks = hitTick;
+			targetIndex = i;
+		}
+	}
+	return flightTicks;
+}
+
+//Works out which tank, if any, a projectile hits, and when its flight ends
+static void SolveProjectile(Match& match, int index)
+{
+	ProjectilePool& projectiles = match.projectiles;
+	int targetIndex;
+	double flightTime = SolveFlight(match, match.tankStore, match.tanksInReach.data(), projectiles.GetTrajectory(index), targetIndex);
+
+	projectiles.impactTime[index] = projectiles.launchTime[index] + flightTime;
+	projectiles.targetIndex[index] = targetIndex;
+
+	LOG_DEBUG("Projectile " << index << " lands after " << flightTime << " s" << (targetIndex == -1 ? ", missing every tank" : ""));
+}
+
+//Deterministic version of SolveProjectile, which looks for the impact after the given step
+static void SolveFixedProjectile(Match& match, int index, long long fromTick)
+{
+	ProjectilePool& projectiles = match.projectiles;
+	int targetIndex;
+	long long flightTicks = SolveFixedFlight(match, match.tankStore, match.tanksInReach.data(), projectiles.fixedTrajectories[index],
+		fromTick - projectiles.launchTick[index], targetIndex);
+
+	projectiles.impactTick[index] = projectiles.launchTick[index] + flightTicks;
+	projectiles.impactTime[index] = GetTickTime(projectiles.impactTick[index]);
+	projectiles.targetIndex[index] = targetIndex;
+
+	LOG_DEBUG("Projectile " << index << " lands after " << flightTicks << " steps" << (targetIndex == -1 ? ", missing every tank" : ""));
+}
+
+//Angle the shellIndex-th shell of a shot aimed at angle leaves at, with the cluster fanned out evenly
+//across clusterSpreadDegrees. In deterministic matches the spread is worked out in whole millidegrees too
+static int GetFixedShellAngle(const Match& match, float angle, int shellIndex, int numberOfShells)
+{
+	int angleMillidegrees = ToMillidegrees(angle);
+	if (numberOfShells > 1)
+	{
+		int spread = ToMillidegrees(match.clusterSpreadDegrees);
+		angleMillidegrees += (int)((int64_t)spread * shellIndex / (numberOfShells - 1)) - spread / 2;
+	}
+	return angleMillidegrees;
+}
+
+static float GetShellAngle(const Match& match, float angle, int shellIndex, int numberOfShells)
+{
+	if (numberOfShells > 1)
+	{
+		angle += match.clusterSpreadDegrees * ((float)shellIndex / (numberOfShells - 1) - 0.5f);
+	}
+	return angle;
+}
+
+static FixedTrajectory MakeFixedShellTrajectory(const Tank& shooter, int angleMillidegrees, Fixed power)
+{
+	return MakeFixedTrajectory(ToFixed(shooter.xCoordinate), ToFixed(shooter.yCoordinate), ToFixed(shooter.tankSize),
+		angleMillidegrees, power, ToFixed(ACCELERATION_DUE_TO_GRAVITY), FixedTicksPerSecond);
+}
+
+static Trajectory MakeShellTrajectory(const Tank& shooter, float angle, float power)
+{
+	//Convert angle to radians
+	float angleInRadians = angle * PI / 180;
+
+	//Projectile initial positions
+	//Ensuring it does not start exactly on the same position as the tank itself and shoot itself initially
+	float startX = shooter.xCoordinate + shooter.tankSize * cos(angleInRadians);
+	float startY = shooter.yCoordinate + shooter.tankSize * sin(angleInRadians);
+	float velocityX = cos(angleInRadians) * power;
+	float velocityY = sin(angleInRadians) * power;
+
+	return { startX, startY, velocityX, velocityY, ACCELERATION_DUE_TO_GRAVITY };
+}
+
+//Fires one shell from a tank along a fixed point flight. Returns false if every projectile slot is in use
+static bool FireFixedShell(Match& match, int shooterIndex, int angleMillidegrees, Fixed power)
+{
+	FixedTrajectory trajectory = MakeFixedShellTrajectory(match.allTanks[shooterIndex], angleMillidegrees, power);
+
+	int index = match.projectiles.Spawn(ToTrajectory(trajectory, FixedTicksPerSecond), match.projectileClock);
+	if (index == -1)
+	{
+		return false;
+	}
+	match.projectiles.SetFixedTrajectory(index, trajectory, match.projectileTick);
+
+	match.checksum = MixChecksum(match.checksum, index);
+	match.checksum = MixChecksum(match.checksum, trajectory.startX);
+	match.checksum = MixChecksum(match.checksum, trajectory.startY);
+	match.checksum = MixChecksum(match.checksum, trajectory.velocityX);
+	match.checksum = MixChecksum(match.checksum, trajectory.velocityY);
+	match.checksum = MixChecksum(match.checksum, match.projectileTick);
+
+	SolveFixedProjectile(match, index, match.projectileTick);
+	return true;
+}
+
+//Fires one shell from a tank. Returns false if every projectile slot is in use
+static bool FireShell(Match& match, int shooterIndex, float angle, float power)
+{
+	int index = match.projectiles.Spawn(MakeShellTrajectory(match.allTanks[shooterIndex], angle, power), match.projectileClock);
+	if (index == -1)
+	{
+		return false;
+	}
+	SolveProjectile(match, index);
+	return true;
+}
+
+//Hands the turn to the next player once the last shell has landed. A cluster can take out every
+//tank left, in which case there is no next player
+static void EndTurn(Match& match)
+{
+	if (!IsGameOver(match))
+	{
+		match.currentPlayer = GetNextPlayerIndex(match, match.currentPlayer);
+	}
+	match.isShooting = false;
+}
+
+void FireProjectile(Match& match)
+{
+	Tank& shooter = match.allTanks[match.currentPlayer];
+
+	//A fresh clock for every turn, so it never grows large enough to lose precision
+	if (match.projectiles.GetActiveCount() == 0)
+	{
+		match.projectileClock = 0;
+		match.projectileTick = 0;
+	}
+
+	int numberOfShells = match.shellsPerShot > 1 ? match.shellsPerShot : 1;
+	for (int i = 0; i < numberOfShells; i++)
+	{
+		bool isFired;
+		if (match.isDeterministic)
+		{
+			isFired = FireFixedShell(match, match.currentPlayer, GetFixedShellAngle(match, shooter.angle, i, numberOfShells), ToFixedThousandths(shooter.power));
+		}
+		else
+		{
+			isFired = FireShell(match, match.currentPlayer, GetShellAngle(match, shooter.angle, i, numberOfShells), shooter.power);
+		}
+
+		if (!isFired)
+		{
+			LOG_WARNING("Every projectile is in flight, " << numberOfShells - i << " shells not fired");
+			break;
+		}
+	}
+
+	PlayAudio(match, 0);
+	match.shotsFired++;
+	match.isTankPoweringUp = false;
+	match.isShooting = true;
+
+	if (match.projectiles.GetActiveCount() == 0)
+	{
+		EndTurn(match);
+	}
+}
+
+int PredictShot(const Match& match, TankStore& tankStore, int* tanksInReach, float angle, float power, ShellPrediction* predictions)
+{
+	const Tank& shooter = match.allTanks[match.currentPlayer];
+	int numberOfShells = match.shellsPerShot > 1 ? match.shellsPerShot : 1;
+	for (int i = 0; i < numberOfShells; i++)
+	{
+		ShellPrediction& prediction = predictions[i];
+		if (match.isDeterministic)
+		{
+			FixedTrajectory trajectory = MakeFixedShellTrajectory(shooter, GetFixedShellAngle(match, angle, i, numberOfShells), ToFixedThousandths(power));
+			long long flightTicks = SolveFixedFlight(match, tankStore, tanksInReach, trajectory, 0, prediction.targetIndex);
+
+			Fixed x, y;
+			GetFixedPosition(trajectory, flightTicks, x, y);
+			prediction.impactX = (float)FromFixed(x);
+			prediction.impactY = (float)FromFixed(y);
+		}
+		else
+		{
+			Trajectory trajectory = MakeShellTrajectory(shooter, GetShellAngle(match, angle, i, numberOfShells), power);
+			double flightTime = SolveFlight(match, tankStore, tanksInReach, trajectory, prediction.targetIndex);
+
+			double x, y;
+			GetTrajectoryPosition(trajectory, flightTime, x, y);
+			prediction.impactX = (float)x;
+			prediction.impactY = (float)y;
+		}
+		prediction.isExploding = prediction.targetIndex != -1 || (prediction.impactX >= 0 && prediction.impactX <= SCREENSIZE_X);
+	}
+	return numberOfShells;
+}
+
+//Returns the index of the player whose turn is next
+int GetNextPlayerIndex(Match& match, int currentPlayerIndex)
+{
+	int nextPlayerIndex = (currentPlayerIndex + 1) % match.numberOfTanks;
+
+	while (match.allTanks[nextPlayerIndex].isAlive == false)
+	{
+		LOG_TRACE("Tank " << nextPlayerIndex + 1 << " of " << match.numberOfTanks << " is destroyed, skipping its turn");
+		nextPlayerIndex = (nextPlayerIndex + 1) % match.numberOfTanks;
+	}
+
+	LOG_DEBUG("Next player is player " << nextPlayerIndex + 1);
+	return nextPlayerIndex;
+}
+
+//Returns the projectile with the earliest impact no later than time, the lowest slot on a tie, or -1 if there is none
+static int FindNextImpact(const Match& match, double time)
+{
+	const ProjectilePool& projectiles = match.projectiles;
+	const int* activeIndices = projectiles.GetActiveIndices();
+
+	int nextIndex = -1;
+	for (int j = 0; j < projectiles.GetActiveCount(); j++)
+	{
+		int i = activeIndices[j];
+		double impactTime = projectiles.impactTime[i];
+		if (impactTime <= time && (nextIndex == -1 || impactTime < projectiles.impactTime[nextIndex] ||
+			(impactTime == projectiles.impactTime[nextIndex] && i < nextIndex)))
+		{
+			nextIndex = i;
+		}
+	}
+	return nextIndex;
+}
+
+//Blasts a crater where a shell lands and drops the living tanks standing in it onto the new ground.
+//Returns false if no ground was in reach, otherwise the span of x the terrain and tanks changed over
+static bool CarveCrater(Match& match, float x, float y, double& lowX, double& highX)
+{
+	int firstColumn, lastColumn;
+	if (!match.terrain.Carve(x, y, CraterRadius, firstColumn, lastColumn))
+	{
+		return false;
+	}
+	lowX = firstColumn;
+	highX = lastColumn + 1;
+
+	for (int j = match.columnTankStart[firstColumn]; j < match.columnTankStart[lastColumn + 1]; j++)
+	{
+		int i = match.tanksByColumn[j];
+		Tank& tank = match.allTanks[i];
+		int groundHeight = (int)floor(match.terrain.GetHeight(tank.xCoordinate));
+		if (!tank.isAlive || groundHeight >= tank.yCoordinate)
+		{
+			continue;
+		}
+
+		tank.yCoordinate = groundHeight;
+		match.tankStore.MoveTank(i, (float)tank.xCoordinate, (float)tank.yCoordinate);
+		lowX = min(lowX, (double)tank.xCoordinate - tank.tankSize);
+		highX = max(highX, (double)tank.xCoordinate + tank.tankSize);
+	}
+	return true;
+}
+
+//True if a shell passes over any x from lowX to highX between now and its impact
+static bool IsFlyingOver(const Match& match, int index, double time, long long tick, double lowX, double highX)
+{
+	const ProjectilePool& projectiles = match.projectiles;
+	double fromX, toX, y;
+	if (match.isDeterministic)
+	{
+		Fixed fixedX, fixedY;
+		GetFixedPosition(projectiles.fixedTrajectories[index], tick - projectiles.launchTick[index], fixedX, fixedY);
+		fromX = FromFixed(fixedX);
+		GetFixedPosition(projectiles.fixedTrajectories[index], projectiles.impactTick[index] - projectiles.launchTick[index], fixedX, fixedY);
+		toX = FromFixed(fixedX);
+	}
+	else
+	{
+		Trajectory trajectory = projectiles.GetTrajectory(index);
+		GetTrajectoryPosition(trajectory, time - projectiles.launchTime[index], fromX, y);
+		GetTrajectoryPosition(trajectory, projectiles.impactTime[index] - projectiles.launchTime[index], toX, y);
+	}
+	return max(fromX, toX) >= lowX && min(fromX, toX) <= highX;
+}
+
+//Blast positions are rounded to whole 1 / BlastSteps pixels, so the damage is worked out with integers
+//and deterministic matches lose the same health everywhere
+static const int64_t BlastSteps = 256;
+
+int GetBlastDamage(const Tank& tank, float x, float y, bool isDirectHit)
+{
+	int64_t blastReach = BlastRadius * BlastSteps;
+
+	//From the blast to the nearest point of the tank
+	int64_t offsetX = tank.xCoordinate * BlastSteps - llround(x * (double)BlastSteps);
+	int64_t offsetY = tank.yCoordinate * BlastSteps - llround(y * (double)BlastSteps);
+	int64_t distance = IntegerSquareRoot(offsetX * offsetX + offsetY * offsetY) - tank.tankSize * BlastSteps;
+	distance = isDirectHit ? 0 : max<int64_t>(distance, 0);
+	if (distance >= blastReach)
+	{
+		return 0;
+	}
+
+	//Rounded up, so every tank the blast reaches loses some health
+	return (int)((BlastDamage * (blastReach - distance) + blastReach - 1) / blastReach);
+}
+
+//Damages every living tank the blast of a shell landing at x, y reaches, and returns how many it destroyed.
+//The tank the shell hit, if any, takes the full BlastDamage
+static int ApplyBlast(Match& match, float x, float y, int targetIndex)
+{
+	int numberDestroyed = 0;
+	int numberInRadius = match.tankStore.FindTanksInRadius(x, y, BlastRadius, match.tanksInReach.data());
+	for (int j = 0; j < numberInRadius; j++)
+	{
+		int i = match.tanksInReach[j];
+		Tank& tank = match.allTanks[i];
+
+		int damage = GetBlastDamage(tank, x, y, i == targetIndex);
+		if (damage == 0)
+		{
+			continue;
+		}
+		tank.health -= damage;
+		if (match.isDeterministic)
+		{
+			match.checksum = MixChecksum(match.checksum, i);
+			match.checksum = MixChecksum(match.checksum, damage);
+		}
+
+		if (tank.health > 0)
+		{
+			LOG_INFO("Tank " << i + 1 << " is caught in the blast and has " << tank.health << " health left.");
+			continue;
+		}
+		tank.isAlive = false;
+		match.tankStore.SetAlive(i, false);
+		LOG_INFO("Tank " << i + 1 << " is caught in the blast and destroyed!");
+		match.deathCount++;
+		numberDestroyed++;
+	}
+	return numberDestroyed;
+}
+
+//Lands a projectile at its impact point and applies what SolveProjectile worked out for it
+static void LandProjectile(Match& match, int index)
+{
+	ProjectilePool& projectiles = match.projectiles;
+	double impactTime = projectiles.impactTime[index];
+	long long impactTick = projectiles.impactTick[index];
+	int targetIndex = projectiles.targetIndex[index];
+
+	if (match.isDeterministic)
+	{
+		projectiles.MoveToTick(index, impactTick);
+		match.checksum = MixChecksum(match.checksum, index);
+		match.checksum = MixChecksum(match.checksum, impactTick);
+		match.checksum = MixChecksum(match.checksum, targetIndex);
+	}
+	else
+	{
+		projectiles.MoveTo(index, impactTime);
+	}
+	float impactX = projectiles.positionX[index];
+	float impactY = projectiles.positionY[index];
+	projectiles.Release(index);
+
+	//Shells that leave the sides of the world do not explode or reach the ground
+	bool isInWorld = impactX >= 0 && impactX <= SCREENSIZE_X;
+	if (targetIndex != -1)
+	{
+		LOG_INFO("Projectile hit Tank " << targetIndex + 1 << "!");
+	}
+
+	int numberDestroyed = targetIndex != -1 || isInWorld ? ApplyBlast(match, impactX, impactY, targetIndex) : 0;
+	if (numberDestroyed > 0)
+	{
+		match.hitCount++;
+		PlayAudio(match, 1);
+	}
+	else
+	{
+		PlayAudio(match, 2);
+	}
+
+	double carvedLowX = 0;
+	double carvedHighX = -1;
+	bool isCarved = isInWorld && CarveCrater(match, impactX, impactY, carvedLowX, carvedHighX);
+	if (!isCarved && numberDestroyed == 0)
+	{
+		return;
+	}
+
+	//Other shells on their way to a destroyed tank now fly on through where it was, and shells over the
+	//crater may now come down somewhere else. The margin covers rounding in the float flights
+	const int* activeIndices = projectiles.GetActiveIndices();
+	for (int j = 0; j < projectiles.GetActiveCount(); j++)
+	{
+		int i = activeIndices[j];
+		bool isAffected = projectiles.targetIndex[i] != -1 && !match.allTanks[projectiles.targetIndex[i]].isAlive;
+		if (!isAffected && isCarved)
+		{
+			isAffected = IsFlyingOver(match, i, impactTime, impactTick, carvedLowX - 1, carvedHighX + 1);
+		}
+		if (!isAffected)
+		{
+			continue;
+		}
+
+		if (match.isDeterministic)
+		{
+			SolveFixedProjectile(match, i, impactTick);
+		}
+		else
+		{
+			projectiles.Rebase(i, impactTime);
+			SolveProjectile(match, i);
+		}
+	}
+}
+
+//Updates the position of every projectile once, when called in the main game loop it will update continuosly
+void CalculateProjectileMotion(Match& match, float timeStep)
+{
+	ProjectilePool& projectiles = match.projectiles;
+	if (match.isDeterministic)
+	{
+		match.projectileTick++;
+		match.projectileClock = GetTickTime(match.projectileTick);
+	}
+	else
+	{
+		match.projectileClock += timeStep;
+	}
+
+	//Land everything due within this step in time order. A hit can send another shell on past the
+	//tank it was aiming for, and that shell may land later in the same step
+	int landingIndex;
+	while ((landingIndex = FindNextImpact(match, match.projectileClock)) != -1)
+	{
+		LandProjectile(match, landingIndex);
+	}
+
+	const int* activeIndices = projectiles.GetActiveIndices();
+	for (int j = 0; j < projectiles.GetActiveCount(); j++)
+	{
+		int i = activeIndices[j];
+		if (match.isDeterministic)
+		{
+			projectiles.MoveToTick(i, match.projectileTick);
+		}
+		else
+		{
+			projectiles.MoveTo(i, match.projectileClock);
+		}
+		projectiles.trails[i].AddPoint(NormalizeCoordinates_X(projectiles.positionX[i]), NormalizeCoordinates_Y(projectiles.positionY[i]));
+
+		LOG_TRACE("Projectile " << i << " position at elapsed time " << match.projectileClock - projectiles.launchTime[i] << ": (" << projectiles.positionX[i] << ", " << projectiles.positionY[i] << ")");
+	}
+
+	if (match.isShooting && projectiles.GetActiveCount() == 0)
+	{
+		EndTurn(match);
+	}
+}
+
+int ResolveShot(Match& match, float timeStep)
+{
+	double startTime = match.projectileClock;
+	long long startTick = match.projectileTick;
+
+	int landingIndex;
+	while ((landingIndex = FindNextImpact(match, HUGE_VAL)) != -1)
+	{
+		if (match.projectiles.impactTime[landingIndex] > match.projectileClock)
+		{
+			match.projectileClock = match.projectiles.impactTime[landingIndex];
+			match.projectileTick = match.projectiles.impactTick[landingIndex];
+		}
+		LandProjectile(match, landingIndex);
+	}
+
+	if (match.isShooting)
+	{
+		EndTurn(match);
+	}
+
+	if (match.isDeterministic)
+	{
+		return match.projectileTick > startTick ? (int)(match.projectileTick - startTick) : 1;
+	}
+
+	double elapsedTime = match.projectileClock - startTime;
+	return elapsedTime > 0 ? (int)ceil(elapsedTime / timeStep) : 1;
+}
+
+uint64_t GetSimulationChecksum(const Match& match)
+{
+	return match.isDeterministic ? MixChecksum(match.checksum, match.projectileTick) : 0;
+}
+
+uint64_t CombineChecksums(uint64_t total, uint64_t checksum)
+{
+	return MixChecksum(total, (int64_t)checksum);
+}
+
+//Returns true once only one tank is left alive
+bool IsGameOver(const Match& match)
+{
+	return match.deathCount >= match.numberOfTanks - 1;
+}
+
+//Returns the index of the first tank still alive, or -1 if there is none
+int GetWinningTankIndex(const Match& match)
+{
+	for (int i = 0; i < match.numberOfTanks; i++)
+	{
+		if (match.allTanks[i].isAlive)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include "Backends.h"
+#include "Ballistics.h"
+#include "FixedBallistics.h"
+#include "ProjectilePool.h"
+#include "TankStore.h"
+#include "Terrain.h"
+#include <random>
+#include <vector>
+
+const float ACCELERATION_DUE_TO_GRAVITY = 9.8f;
+const int SCREENSIZE_X = 1000;
+const int SCREENSIZE_Y = 800;
+const float PI = 3.14;
+
+//Seconds of game time simulated by each call to CalculateProjectileMotion
+const float SimulationTimeStep = 0.01f;
+
+//Calls to CalculateProjectileMotion per second of game time, for the fixed point flights of deterministic matches
+const int FixedTicksPerSecond = 100;
+
+//Calls to CalculateProjectileMotion per wall clock second at normal speed. The game used to make
+//one call per rendered frame, so this keeps shells flying as fast as they did at 60 frames per second
+const double SimulationTicksPerSecond = 60;
+const int MaxSimulationTicksPerFrame = 1000;
+
+const float TankMinPower = 10;
+const float TankMaxPower = 100;
+const float TankMinAngle = 20;
+const float TankMaxAngle = 180 - TankMinAngle;
+
+//Height of the ground across the world at the start of a match
+const float TerrainStartHeight = 100;
+
+//Radius of the crater a landing shell blasts out of the ground, in pixels
+const int CraterRadius = 16;
+
+//Health a tank starts with. It is destroyed once it has lost all of it
+const int TankMaxHealth = 100;
+
+//A landing shell damages every tank within BlastRadius pixels of it, measured to the nearest point of the tank.
+//The damage falls off evenly from BlastDamage at the point of impact, which a tank hit directly always takes,
+//to nothing at the edge of the blast
+const int BlastRadius = 30;
+const int BlastDamage = 100;
+
+//Largest number of tanks a windowed match can be started with
+const int MaxNumberOfTanks = 5000;
+
+struct Tank
+{
+	int xCoordinate = 0;
+	int yCoordinate = 0;
+	int tankSize = 0; //Radius of tank from center
+	bool isAlive = true;
+	int health = TankMaxHealth;
+	float angle = TankMinAngle;
+	float power = 0;
+};
+
+//Everything one game needs. Each match owns its own state, so several matches can be
+//played at once on different threads without sharing anything
+struct Match
+{
+	int numberOfTanks = 0;
+	int deathCount = 0;
+	int currentPlayer = 0;
+
+	//Every shell in flight. Each one's whole flight is worked out when it is fired, and the steps only
+	//move it along its trajectory until its impact time, so no tank can be skipped over between two steps
+	ProjectilePool projectiles;
+
+	//Seconds simulated since the current turn's shells were fired. Launch and impact times are on this clock
+	double projectileClock = 0;
+
+	//Flies every shell along a FixedTrajectory instead, in whole steps, so the match plays out bit for
+	//bit the same with any compiler, flags or CPU. Set before SpawnTanks
+	bool isDeterministic = false;
+
+	//Deterministic matches only: steps simulated since the current turn's shells were fired, and a running
+	//hash of the tanks and of every shell fired and landed so far. See GetSimulationChecksum
+	long long projectileTick = 0;
+	uint64_t checksum = 0;
+
+	//Shells fired per shot, fanned out evenly across clusterSpreadDegrees around the aim
+	int shellsPerShot = 1;
+	float clusterSpreadDegrees = 6;
+
+	//True from firing until the last shell of the turn has landed
+	bool isShooting = false;
+	bool isTankPoweringUp = false;
+
+	Terrain terrain;
+
+	std::vector<Tank> allTanks;
+
+	//The tanks sorted by the terrain column under their center, so a crater only looks at the tanks
+	//standing in it. Column c's tanks are tanksByColumn[columnTankStart[c]] up to columnTankStart[c + 1]
+	std::vector<int> tanksByColumn;
+	std::vector<int> columnTankStart;
+
+	//Copy of the tanks' positions, sizes and whether they are alive, laid out for the collision
+	//tests. SpawnTanks and the shots keep it in step with allTanks
+	TankStore tankStore;
+	std::vector<int> tanksInReach; //Scratch space for the tank queries, one slot per tank
+
+	//Number of shots fired and how many of the shells destroyed at least one tank
+	int shotsFired = 0;
+	int hitCount = 0;
+
+	//Where sound effects triggered by the simulation are sent. Defaults to a null backend
+	AudioBackend* audioBackend = nullptr;
+
+	//Used for tank spawns, so a match can be replayed from its seed
+	std::mt19937 randomGenerator;
+};
+
+// Convert Game Coordinates to OpenGL's Coordinate system
+float NormalizeCoordinates_X(float x);
+float NormalizeCoordinates_Y(float y);
+
+void PlayAudio(Match& match, int trackIndex);
+
+//Resets the match state and spawns the given number of tanks with random details
+void SpawnTanks(Match& match, int tankCount);
+
+//Launches shellsPerShot projectiles from the current player's tank using its angle and power, and
+//works out where and when each lands. The turn passes once all of them have
+void FireProjectile(Match& match);
+
+//Where one shell of a shot comes down. isExploding is false for a shell that leaves the sides of the world
+struct ShellPrediction
+{
+	float impactX = 0;
+	float impactY = 0;
+	int targetIndex = -1;
+	bool isExploding = false;
+};
+
+//Works out where each shell of the current player's shot at the given angle and power would land, the same way
+//FireProjectile does for a turn with no shells in flight, without firing it or changing the match. Writes one
+//prediction per shell to predictions and returns how many there are. The tank queries go through tankStore, a
+//copy of match.tankStore, with tanksInReach as scratch space, so several threads can predict shots at once
+int PredictShot(const Match& match, TankStore& tankStore, int* tanksInReach, float angle, float power, ShellPrediction* predictions);
+
+//Health a tank loses to the blast of a shell landing at x, y, or 0 if the blast does not reach it.
+//isDirectHit for the tank the shell hit, which takes the full BlastDamage
+int GetBlastDamage(const Tank& tank, float x, float y, bool isDirectHit);
+
+//Returns the index of the player whose turn is next
+int GetNextPlayerIndex(Match& match, int currentPlayerIndex);
+
+//Updates the position of every projectile once, when called in the main game loop it will update
+//continuosly. Impacts within the step are handled earliest first. Deterministic matches always step
+//by SimulationTimeStep
+void CalculateProjectileMotion(Match& match, float timeStep);
+
+//Lands every projectile in flight straight away, as if CalculateProjectileMotion had been called
+//until the last one landed. Returns how many calls that would have taken
+int ResolveShot(Match& match, float timeStep);
+
+//Hash of a deterministic match's state at the current step, or 0 if the match is not deterministic.
+//The same match played from the same inputs gives the same hash after every CalculateProjectileMotion
+//call on any machine, so replays and lockstep sessions can compare it instead of the whole state
+uint64_t GetSimulationChecksum(const Match& match);
+
+//Folds the checksum of another match into a running total. The order matters
+uint64_t CombineChecksums(uint64_t total, uint64_t checksum);
+
+//Returns true once at most one tank is left alive
+bool IsGameOver(const Match& match);
+
+//Returns the index of the first tank still alive, or -1 if there is none
+int GetWinningTankIndex(const Match& match);
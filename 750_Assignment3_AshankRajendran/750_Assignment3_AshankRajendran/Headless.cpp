@@ -0,0 +1,171 @@
+#include "Headless.h"
+#include "Audio.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+static const unsigned int LoopbackSampleRate = 48000;
+
+//Stands in for keyboardInputCallback: aims and powers the current player's tank, then fires
+static void FireScriptedShot(Match& match, const AimError* aimError, ShotSearch* shotSearch)
+{
+	Tank& shooter = match.allTanks[match.currentPlayer];
+
+	if (shotSearch != nullptr)
+	{
+		shotSearch->AimCurrentPlayer(match);
+	}
+	else if (aimError != nullptr)
+	{
+		AimComputerPlayer(match, *aimError);
+	}
+	else if (match.isDeterministic)
+	{
+		//The distributions differ between standard libraries, mt19937 itself does not. Whole thousandths of a
+		//degree and of a pixel per second
+		unsigned int angleSteps = (unsigned int)(TankMaxAngle - TankMinAngle) * 1000 + 1;
+		unsigned int powerSteps = (unsigned int)(TankMaxPower - TankMinPower) * 1000 + 1;
+		shooter.angle = TankMinAngle + (match.randomGenerator() % angleSteps) / 1000.0f;
+		shooter.power = TankMinPower + (match.randomGenerator() % powerSteps) / 1000.0f;
+	}
+	else
+	{
+		uniform_real_distribution<float> angleDistribution(TankMinAngle, TankMaxAngle);
+		uniform_real_distribution<float> powerDistribution(TankMinPower, TankMaxPower);
+		shooter.angle = angleDistribution(match.randomGenerator);
+		shooter.power = powerDistribution(match.randomGenerator);
+	}
+	FireProjectile(match);
+}
+
+MatchStatistics PlayScriptedMatch(Match& match, int tanksPerMatch, int maxTurnsPerMatch, unsigned int seed, bool isSteppingShots, const AimError* aimError, ShotSearch* shotSearch)
+{
+	NullRenderBackend nullRenderBackend;
+	MatchStatistics statistics;
+
+	match.randomGenerator.seed(seed);
+	SpawnTanks(match, tanksPerMatch);
+
+	while (!IsGameOver(match) && statistics.turns < maxTurnsPerMatch)
+	{
+		FireScriptedShot(match, aimError, shotSearch);
+		statistics.turns++;
+
+		if (!isSteppingShots)
+		{
+			statistics.simulationSteps += ResolveShot(match, SimulationTimeStep);
+			continue;
+		}
+
+		while (match.isShooting)
+		{
+			CalculateProjectileMotion(match, SimulationTimeStep);
+			nullRenderBackend.DrawFrame(match, 1);
+			if (match.audioBackend != nullptr)
+			{
+				match.audioBackend->OnSimulationTick();
+			}
+			statistics.simulationSteps++;
+		}
+	}
+
+	statistics.hits = match.hitCount;
+	statistics.checksum = GetSimulationChecksum(match);
+	if (IsGameOver(match))
+	{
+		statistics.winningTankIndex = GetWinningTankIndex(match);
+	}
+	return statistics;
+}
+
+int RunHeadlessSimulation(const HeadlessOptions& options)
+{
+	if (options.numberOfMatches < 1 || options.tanksPerMatch < 2)
+	{
+		cerr << "Headless mode needs at least 1 match and 2 tanks per match" << endl;
+		return -1;
+	}
+
+	NullAudioBackend nullAudioBackend;
+	LoopbackAudioBackend loopbackAudioBackend(1 / SimulationTicksPerSecond);
+	bool isRenderingAudio = !options.audioOutputPath.empty();
+
+	if (isRenderingAudio && !InitializeLoopbackAudio(LoopbackSampleRate))
+	{
+		return -1;
+	}
+	if (isRenderingAudio && !options.ambiencePath.empty())
+	{
+		PlayAudioStream(options.ambiencePath, true);
+	}
+
+	Match match;
+	match.audioBackend = isRenderingAudio ? (AudioBackend*)&loopbackAudioBackend : &nullAudioBackend;
+	match.shellsPerShot = options.shellsPerShot;
+	match.isDeterministic = options.isDeterministic;
+
+	//Only started when asked for, as it brings up a thread pool
+	unique_ptr<ShotSearch> shotSearch;
+	if (options.isSearchingShots)
+	{
+		shotSearch = make_unique<ShotSearch>(options.searchOptions);
+	}
+
+	long long totalTurns = 0;
+	long long totalSteps = 0;
+	uint64_t checksum = 0;
+	int draws = 0;
+
+	auto startTime = chrono::steady_clock::now();
+
+	for (int i = 0; i < options.numberOfMatches; i++)
+	{
+		MatchStatistics statistics = PlayScriptedMatch(match, options.tanksPerMatch, options.maxTurnsPerMatch, options.seed + i, isRenderingAudio,
+			options.isComputerAiming ? &options.aimError : nullptr, shotSearch.get());
+
+		if (statistics.winningTankIndex == -1)
+		{
+			draws++;
+		}
+		totalTurns += statistics.turns;
+		totalSteps += statistics.simulationSteps;
+		checksum = CombineChecksums(checksum, statistics.checksum);
+	}
+
+	double elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	cout << "\nHeadless simulation finished";
+	cout << "\nMatches: " << options.numberOfMatches << " (" << draws << " without a winner)";
+	cout << "\nTurns: " << totalTurns << ", simulation steps: " << totalSteps;
+	if (options.isDeterministic)
+	{
+		cout << "\nChecksum: " << hex << setw(16) << setfill('0') << checksum << dec << setfill(' ');
+	}
+	cout << "\nElapsed time: " << elapsedSeconds << " s";
+	cout << "\nMatches per second: " << options.numberOfMatches / elapsedSeconds;
+	cout << "\nTurns per second: " << totalTurns / elapsedSeconds << "\n";
+
+	if (isRenderingAudio)
+	{
+		AudioRenderStatistics renderStatistics = GetAudioRenderStatistics();
+		cout << "\nAudio ticks rendered: " << renderStatistics.ticks;
+		if (renderStatistics.ticks > 0)
+		{
+			cout << "\nAudio render time per tick: " << renderStatistics.totalSeconds / renderStatistics.ticks * 1e6 << " us average, " << renderStatistics.maxSeconds * 1e6 << " us worst";
+		}
+		cout << "\n";
+
+		bool isSaved = SaveRenderedAudio(options.audioOutputPath);
+		ShutdownAudio();
+		if (!isSaved)
+		{
+			cerr << "failed to write " << options.audioOutputPath << endl;
+			return -1;
+		}
+		cout << "Audio written to " << options.audioOutputPath << "\n";
+	}
+	return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "ComputerPlayer.h"
+#include "Game.h"
+#include "ShotSearch.h"
+#include <string>
+
+struct HeadlessOptions
+{
+	int numberOfMatches = 1000;
+	int tanksPerMatch = 4;
+	unsigned int seed = 1;
+
+	//Matches that have not finished after this many shots are counted as draws
+	int maxTurnsPerMatch = 10000;
+
+	//Shells fired per shot, see Match::shellsPerShot
+	int shellsPerShot = 1;
+
+	//Plays Match::isDeterministic matches and reports their combined checksum
+	bool isDeterministic = false;
+
+	//Has every tank aim with AimComputerPlayer, off by up to aimError, instead of shooting at random
+	bool isComputerAiming = false;
+	AimError aimError;
+
+	//Has every tank pick its shots with a ShotSearch instead, which takes precedence over isComputerAiming
+	bool isSearchingShots = false;
+	ShotSearchOptions searchOptions;
+
+	//If set, the matches' sound effects are mixed through an OpenAL loopback device, one simulation
+	//tick at a time, and written here as a .wav file. Meant for short runs, as the whole mix is kept in memory
+	std::string audioOutputPath;
+
+	//If set along with audioOutputPath, this .wav file is streamed with PlayAudioStream and looped behind
+	//the sound effects for the whole run
+	std::string ambiencePath;
+};
+
+//Outcome of one match played by PlayScriptedMatch
+struct MatchStatistics
+{
+	int winningTankIndex = -1; //-1 if the match hit the turn limit or the last tanks fell to the same shot
+	int turns = 0;
+	int hits = 0;
+	long long simulationSteps = 0;
+	uint64_t checksum = 0; //GetSimulationChecksum at the end of the match
+};
+
+//Plays one match with scripted shots from start to finish on the calling thread.
+//The match is seeded with the given seed, so the same seed always plays the same match.
+//Shots are resolved in one go unless isSteppingShots, which flies them a simulation step at a
+//time for backends that need to see every step. Deterministic matches also draw their shots with
+//integer math, so they play out the same everywhere. With aimError, every tank aims at another with
+//AimComputerPlayer instead of shooting at random, and with shotSearch every tank picks its shots with it
+MatchStatistics PlayScriptedMatch(Match& match, int tanksPerMatch, int maxTurnsPerMatch, unsigned int seed, bool isSteppingShots = false,
+	const AimError* aimError = nullptr, ShotSearch* shotSearch = nullptr);
+
+//Plays matches with scripted shots against the null audio and render backends, without
+//opening a window or an audio device, then reports the throughput. Returns the process exit code.
+//With audioOutputPath set, audio goes through LoopbackAudioBackend instead
+int RunHeadlessSimulation(const HeadlessOptions& options);
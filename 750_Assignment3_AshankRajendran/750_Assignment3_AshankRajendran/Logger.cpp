@@ -0,0 +1,310 @@
+#include "Logger.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static const int LogEntryTextSize = 248;
+static const int LogRingCapacity = 4096;
+
+struct LogEntry
+{
+	LogLevel level;
+	int length;
+	char text[LogEntryTextSize];
+};
+
+//Single producer, single consumer queue of messages. Only the owning thread pushes and only the
+//drain thread pops, so the two indices are all the synchronisation needed
+struct LogRing
+{
+	LogEntry entries[LogRingCapacity];
+	alignas(64) atomic<unsigned long long> writeIndex{ 0 };
+	alignas(64) atomic<unsigned long long> readIndex{ 0 };
+	atomic<unsigned long long> droppedMessages{ 0 };
+
+	//Set when the owning thread exits, so the drain thread can forget the ring once it is empty
+	atomic<bool> isRetired{ false };
+};
+
+//Registers the calling thread's ring on first use and retires it when the thread exits
+struct LogThreadHandle
+{
+	shared_ptr<LogRing> ring;
+	~LogThreadHandle()
+	{
+		if (ring)
+		{
+			ring->isRetired.store(true, memory_order_release);
+		}
+	}
+};
+
+atomic<int> currentLogLevel{ (int)LogLevel::Info };
+
+//Guards allRings only. The drain thread copies the list into drainingRings under the lock and reads the
+//rings after releasing it, so a thread registering its ring never waits on the formatting
+static mutex ringsMutex;
+static vector<shared_ptr<LogRing>> allRings;
+static vector<shared_ptr<LogRing>> drainingRings;
+
+static mutex drainMutex;
+static condition_variable drainCondition;
+static thread drainThread;
+static bool isDrainRunning = false;
+
+static thread_local LogThreadHandle threadHandle;
+
+//Returning from main without calling StopLogger would destroy drainThread while it is still
+//running, which ends the program, so stop it on the way out. Declared after the state it uses
+//so it is destroyed first
+static struct LoggerExitGuard
+{
+	~LoggerExitGuard()
+	{
+		StopLogger();
+	}
+} loggerExitGuard;
+
+void SetLogLevel(LogLevel level)
+{
+	currentLogLevel.store((int)level, memory_order_relaxed);
+}
+
+LogLevel GetLogLevel()
+{
+	return (LogLevel)currentLogLevel.load(memory_order_relaxed);
+}
+
+bool ParseLogLevel(const char* name, LogLevel& level)
+{
+	static const char* levelNames[] = { "trace", "debug", "info", "warning", "error", "off" };
+	for (int i = 0; i <= (int)LogLevel::Off; i++)
+	{
+		if (strcmp(name, levelNames[i]) == 0)
+		{
+			level = (LogLevel)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+static LogRing& GetThreadRing()
+{
+	if (!threadHandle.ring)
+	{
+		//Only the first message from each thread allocates and takes the lock, which is held just long
+		//enough to add the ring to the list
+		threadHandle.ring = make_shared<LogRing>();
+		lock_guard<mutex> lock(ringsMutex);
+		allRings.push_back(threadHandle.ring);
+	}
+	return *threadHandle.ring;
+}
+
+static void PushMessage(LogLevel level, const char* text, int length)
+{
+	LogRing& ring = GetThreadRing();
+
+	unsigned long long writeIndex = ring.writeIndex.load(memory_order_relaxed);
+	if (writeIndex - ring.readIndex.load(memory_order_acquire) >= LogRingCapacity)
+	{
+		ring.droppedMessages.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	LogEntry& entry = ring.entries[writeIndex % LogRingCapacity];
+	entry.level = level;
+	entry.length = length;
+	memcpy(entry.text, text, length);
+
+	ring.writeIndex.store(writeIndex + 1, memory_order_release);
+}
+
+//Moves every queued message into one string so stdout is written once per pass. Returns false if there was nothing to write.
+//Only called from one thread at a time: the drain thread, or StopLogger once it has joined
+static bool DrainRings(string& output)
+{
+	output.clear();
+
+	{
+		lock_guard<mutex> lock(ringsMutex);
+		drainingRings = allRings;
+	}
+
+	bool hasRetiredRings = false;
+	for (const shared_ptr<LogRing>& ringPointer : drainingRings)
+	{
+		LogRing& ring = *ringPointer;
+		bool isRetired = ring.isRetired.load(memory_order_acquire);
+
+		unsigned long long readIndex = ring.readIndex.load(memory_order_relaxed);
+		unsigned long long writeIndex = ring.writeIndex.load(memory_order_acquire);
+		for (; readIndex < writeIndex; readIndex++)
+		{
+			const LogEntry& entry = ring.entries[readIndex % LogRingCapacity];
+			if (entry.level == LogLevel::Warning)
+			{
+				output += "Warning: ";
+			}
+			else if (entry.level == LogLevel::Error)
+			{
+				output += "Error: ";
+			}
+			output.append(entry.text, entry.length);
+			output += '\n';
+		}
+		ring.readIndex.store(readIndex, memory_order_release);
+
+		unsigned long long droppedMessages = ring.droppedMessages.exchange(0, memory_order_relaxed);
+		if (droppedMessages > 0)
+		{
+			output += "Warning: " + to_string(droppedMessages) + " log messages dropped\n";
+		}
+
+		//Nothing more can arrive from a thread that has exited, so its ring is dropped below once it is empty
+		hasRetiredRings = hasRetiredRings || isRetired;
+	}
+
+	if (hasRetiredRings)
+	{
+		lock_guard<mutex> lock(ringsMutex);
+		for (size_t i = 0; i < allRings.size();)
+		{
+			LogRing& ring = *allRings[i];
+			if (ring.isRetired.load(memory_order_acquire) && ring.readIndex.load(memory_order_relaxed) == ring.writeIndex.load(memory_order_acquire))
+			{
+				allRings.erase(allRings.begin() + i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+	drainingRings.clear();
+	return !output.empty();
+}
+
+static void RunDrainThread()
+{
+	string output;
+	unique_lock<mutex> lock(drainMutex);
+	while (isDrainRunning)
+	{
+		drainCondition.wait_for(lock, chrono::milliseconds(5));
+
+		lock.unlock();
+		if (DrainRings(output))
+		{
+			fwrite(output.data(), 1, output.size(), stdout);
+			fflush(stdout);
+		}
+		lock.lock();
+	}
+}
+
+void StartLogger()
+{
+	lock_guard<mutex> lock(drainMutex);
+	if (isDrainRunning)
+	{
+		return;
+	}
+	isDrainRunning = true;
+	drainThread = thread(RunDrainThread);
+}
+
+void StopLogger()
+{
+	{
+		lock_guard<mutex> lock(drainMutex);
+		if (!isDrainRunning)
+		{
+			return;
+		}
+		isDrainRunning = false;
+	}
+	drainCondition.notify_one();
+	drainThread.join();
+
+	//Catch anything logged after the drain thread's last pass
+	string output;
+	if (DrainRings(output))
+	{
+		fwrite(output.data(), 1, output.size(), stdout);
+		fflush(stdout);
+	}
+}
+
+//Stream buffer over a fixed array. Anything past the end of the array is thrown away
+class LogTextBuffer : public streambuf
+{
+public:
+	LogTextBuffer()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		setp(text, text + LogEntryTextSize);
+	}
+
+	const char* GetText() const
+	{
+		return text;
+	}
+
+	int GetLength() const
+	{
+		return (int)(pptr() - pbase());
+	}
+
+protected:
+	int_type overflow(int_type character) override
+	{
+		return traits_type::not_eof(character);
+	}
+
+private:
+	char text[LogEntryTextSize];
+};
+
+struct LogFormatter
+{
+	LogTextBuffer buffer;
+	ostream stream{ &buffer };
+};
+
+static thread_local LogFormatter threadFormatter;
+
+LogMessage::LogMessage(LogLevel level)
+	: level(level), stream(threadFormatter.stream)
+{
+	//A message's manipulators, like hex or setprecision, must not carry over into the next one
+	threadFormatter.buffer.Reset();
+	stream.clear();
+	stream.flags(ios::dec | ios::skipws);
+	stream.precision(6);
+	stream.width(0);
+	stream.fill(' ');
+}
+
+LogMessage::~LogMessage()
+{
+	PushMessage(level, threadFormatter.buffer.GetText(), threadFormatter.buffer.GetLength());
+}
+
+ostream& LogMessage::GetStream()
+{
+	return stream;
+}
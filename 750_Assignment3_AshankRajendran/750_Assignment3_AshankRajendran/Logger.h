@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <ostream>
+
+//Message levels, from the chattiest to the most severe. Off disables all logging
+enum class LogLevel
+{
+	Trace = 0,
+	Debug = 1,
+	Info = 2,
+	Warning = 3,
+	Error = 4,
+	Off = 5
+};
+
+//Levels below this are compiled out entirely, so their messages cost nothing at runtime.
+//Release builds keep Info and above unless the build defines LOG_COMPILED_LEVEL itself
+#ifndef LOG_COMPILED_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILED_LEVEL 2
+#else
+#define LOG_COMPILED_LEVEL 0
+#endif
+#endif
+
+extern std::atomic<int> currentLogLevel;
+
+//Levels below the runtime level are skipped before their message is formatted
+inline bool IsLogLevelEnabled(LogLevel level)
+{
+	return (int)level >= currentLogLevel.load(std::memory_order_relaxed);
+}
+
+void SetLogLevel(LogLevel level);
+LogLevel GetLogLevel();
+
+//Parses "trace", "debug", "info", "warning", "error" or "off". Returns false if the name is not a level
+bool ParseLogLevel(const char* name, LogLevel& level);
+
+//Starts the background thread that writes queued messages to stdout. Messages logged before
+//this are kept in their thread's buffer until the logger starts
+void StartLogger();
+
+//Writes out everything still queued and stops the background thread
+void StopLogger();
+
+//Formats one message on the calling thread and queues it when it goes out of scope. Messages are
+//formatted into a fixed per-thread buffer and cut off at 248 characters, with the stream's formatting
+//reset for each one. A thread's first message sets up its queue, which allocates and briefly takes a
+//lock; after that queueing never blocks or allocates. If the thread's queue is full the message is
+//dropped and counted instead
+class LogMessage
+{
+public:
+	explicit LogMessage(LogLevel level);
+	~LogMessage();
+
+	std::ostream& GetStream();
+
+private:
+	LogLevel level;
+	std::ostream& stream;
+};
+
+#define LOG_AT(level, message) \
+	do \
+	{ \
+		if (IsLogLevelEnabled(level)) \
+		{ \
+			LogMessage logMessage(level); \
+			logMessage.GetStream() << message; \
+		} \
+	} while (0)
+
+#define LOG_DISABLED(message) do {} while (0)
+
+#if LOG_COMPILED_LEVEL <= 0
+#define LOG_TRACE(message) LOG_AT(LogLevel::Trace, message)
+#else
+#define LOG_TRACE(message) LOG_DISABLED(message)
+#endif
+
+#if LOG_COMPILED_LEVEL <= 1
+#define LOG_DEBUG(message) LOG_AT(LogLevel::Debug, message)
+#else
+#define LOG_DEBUG(message) LOG_DISABLED(message)
+#endif
+
+#if LOG_COMPILED_LEVEL <= 2
+#define LOG_INFO(message) LOG_AT(LogLevel::Info, message)
+#else
+#define LOG_INFO(message) LOG_DISABLED(message)
+#endif
+
+#if LOG_COMPILED_LEVEL <= 3
+#define LOG_WARNING(message) LOG_AT(LogLevel::Warning, message)
+#else
+#define LOG_WARNING(message) LOG_DISABLED(message)
+#endif
+
+#define LOG_ERROR(message) LOG_AT(LogLevel::Error, message)
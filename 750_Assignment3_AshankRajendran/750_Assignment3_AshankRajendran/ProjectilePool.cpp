@@ -0,0 +1,128 @@
+#include "ProjectilePool.h"
+
+using namespace std;
+
+ProjectilePool::ProjectilePool(int capacity)
+	: startX(capacity), startY(capacity), velocityX(capacity), velocityY(capacity), gravity(capacity), launchTime(capacity),
+	impactTime(capacity), targetIndex(capacity, -1),
+	positionX(capacity), positionY(capacity), previousPositionX(capacity), previousPositionY(capacity),
+	trails(capacity, ProjectileTrail(PooledTrailCapacity, PooledTrailDecimation)),
+	fixedTrajectories(capacity), launchTick(capacity), impactTick(capacity),
+	activePositions(capacity, -1)
+{
+	freeSlots.reserve(capacity);
+	activeIndices.reserve(capacity);
+	Clear();
+}
+
+int ProjectilePool::Spawn(const Trajectory& trajectory, double launchTime)
+{
+	if (freeSlots.empty())
+	{
+		return -1;
+	}
+	int index = freeSlots.back();
+	freeSlots.pop_back();
+
+	activePositions[index] = (int)activeIndices.size();
+	activeIndices.push_back(index);
+
+	startX[index] = trajectory.startX;
+	startY[index] = trajectory.startY;
+	velocityX[index] = trajectory.velocityX;
+	velocityY[index] = trajectory.velocityY;
+	gravity[index] = trajectory.gravity;
+	this->launchTime[index] = launchTime;
+	impactTime[index] = launchTime;
+	targetIndex[index] = -1;
+
+	positionX[index] = previousPositionX[index] = (float)trajectory.startX;
+	positionY[index] = previousPositionY[index] = (float)trajectory.startY;
+	trails[index].Clear();
+	return index;
+}
+
+void ProjectilePool::Release(int index)
+{
+	//Fill the gap with the last active slot
+	int position = activePositions[index];
+	int lastIndex = activeIndices.back();
+	activeIndices[position] = lastIndex;
+	activePositions[lastIndex] = position;
+	activeIndices.pop_back();
+
+	activePositions[index] = -1;
+	freeSlots.push_back(index);
+}
+
+void ProjectilePool::Clear()
+{
+	activeIndices.clear();
+	freeSlots.clear();
+
+	//Handed out from the back, so the lowest slots go first
+	for (int i = GetCapacity() - 1; i >= 0; i--)
+	{
+		freeSlots.push_back(i);
+		activePositions[i] = -1;
+	}
+}
+
+int ProjectilePool::GetCapacity() const
+{
+	return (int)activePositions.size();
+}
+
+int ProjectilePool::GetActiveCount() const
+{
+	return (int)activeIndices.size();
+}
+
+const int* ProjectilePool::GetActiveIndices() const
+{
+	return activeIndices.data();
+}
+
+Trajectory ProjectilePool::GetTrajectory(int index) const
+{
+	return { startX[index], startY[index], velocityX[index], velocityY[index], gravity[index] };
+}
+
+void ProjectilePool::Rebase(int index, double time)
+{
+	Trajectory trajectory = GetTrajectory(index);
+	double flightTime = time - launchTime[index];
+
+	GetTrajectoryPosition(trajectory, flightTime, startX[index], startY[index]);
+	velocityY[index] = GetTrajectoryVelocityY(trajectory, flightTime);
+	launchTime[index] = time;
+}
+
+void ProjectilePool::MoveTo(int index, double time)
+{
+	previousPositionX[index] = positionX[index];
+	previousPositionY[index] = positionY[index];
+
+	double x, y;
+	GetTrajectoryPosition(GetTrajectory(index), time - launchTime[index], x, y);
+	positionX[index] = (float)x;
+	positionY[index] = (float)y;
+}
+
+void ProjectilePool::SetFixedTrajectory(int index, const FixedTrajectory& trajectory, long long launchTick)
+{
+	fixedTrajectories[index] = trajectory;
+	this->launchTick[index] = launchTick;
+	impactTick[index] = launchTick;
+}
+
+void ProjectilePool::MoveToTick(int index, long long tick)
+{
+	previousPositionX[index] = positionX[index];
+	previousPositionY[index] = positionY[index];
+
+	Fixed x, y;
+	GetFixedPosition(fixedTrajectories[index], tick - launchTick[index], x, y);
+	positionX[index] = (float)FromFixed(x);
+	positionY[index] = (float)FromFixed(y);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "Ballistics.h"
+#include "FixedBallistics.h"
+#include "ProjectileTrail.h"
+#include <vector>
+
+const int DefaultProjectileCapacity = 256;
+
+//Trails of pooled shells keep every other step, so a whole flight still fits in a smaller ring
+const int PooledTrailCapacity = 1024;
+const int PooledTrailDecimation = 2;
+
+//Every shell in flight, as a structure of arrays indexed by slot. Slots come from a free list and go
+//back on impact, and each keeps its trail ring, so firing never allocates once the pool is built
+class ProjectilePool
+{
+public:
+	explicit ProjectilePool(int capacity = DefaultProjectileCapacity);
+
+	//Takes a free slot for a shell launched along trajectory at launchTime, with an empty trail.
+	//Returns the slot, or -1 if every slot is in flight
+	int Spawn(const Trajectory& trajectory, double launchTime);
+	void Release(int index);
+	void Clear();
+
+	int GetCapacity() const;
+	int GetActiveCount() const;
+
+	//Slots of the shells in flight, in no particular order
+	const int* GetActiveIndices() const;
+
+	//Trajectory of the shell in a slot, with time 0 at its launch time
+	Trajectory GetTrajectory(int index) const;
+
+	//Restarts the shell's trajectory from where it is at time. It flies on along the same curve,
+	//but can be solved again from that point
+	void Rebase(int index, double time);
+
+	//Moves the shell to where it is at time, keeping where it was for drawing in between
+	void MoveTo(int index, double time);
+
+	//Gives the slot a fixed point flight as well, launched at launchTick, for deterministic matches
+	void SetFixedTrajectory(int index, const FixedTrajectory& trajectory, long long launchTick);
+
+	//Moves the shell to where its fixed point flight puts it at tick, like MoveTo
+	void MoveToTick(int index, long long tick);
+
+	//Launch state of each slot
+	std::vector<double> startX;
+	std::vector<double> startY;
+	std::vector<double> velocityX;
+	std::vector<double> velocityY;
+	std::vector<double> gravity;
+	std::vector<double> launchTime;
+
+	//Outcome of each slot's flight: when it ends and the tank it destroys, or -1 for none
+	std::vector<double> impactTime;
+	std::vector<int> targetIndex;
+
+	//Where each shell is now and was one step ago
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> previousPositionX;
+	std::vector<float> previousPositionY;
+
+	std::vector<ProjectileTrail> trails;
+
+	//Deterministic matches only: each slot's fixed point flight, and the ticks it was launched and lands at
+	std::vector<FixedTrajectory> fixedTrajectories;
+	std::vector<long long> launchTick;
+	std::vector<long long> impactTick;
+
+private:
+	std::vector<int> freeSlots;
+	std::vector<int> activeIndices;
+	std::vector<int> activePositions; //Where each slot is in activeIndices, so releasing is O(1)
+};
@@ -0,0 +1,72 @@
+#include "ProjectileTrail.h"
+
+ProjectileTrail::ProjectileTrail(int capacity, int decimation)
+	: capacity(capacity < 2 ? 2 : capacity), decimation(decimation < 1 ? 1 : decimation)
+{
+	slots.resize((this->capacity + 1) * 2);
+
+	//The first point after a clear is always kept
+	pointsSkipped = this->decimation - 1;
+}
+
+void ProjectileTrail::AddPoint(float x, float y)
+{
+	if (++pointsSkipped < decimation)
+	{
+		return;
+	}
+	pointsSkipped = 0;
+
+	slots[2 * nextSlot] = x;
+	slots[2 * nextSlot + 1] = y;
+	if (nextSlot == 0)
+	{
+		slots[2 * capacity] = x;
+		slots[2 * capacity + 1] = y;
+	}
+
+	nextSlot = (nextSlot + 1) % capacity;
+	if (pointCount < capacity)
+	{
+		pointCount++;
+	}
+	totalPointsKept++;
+}
+
+void ProjectileTrail::Clear()
+{
+	pointCount = 0;
+	nextSlot = 0;
+	pointsSkipped = decimation - 1;
+	generation++;
+}
+
+int ProjectileTrail::GetCapacity() const
+{
+	return capacity;
+}
+
+int ProjectileTrail::GetPointCount() const
+{
+	return pointCount;
+}
+
+int ProjectileTrail::GetOldestSlot() const
+{
+	return pointCount < capacity ? 0 : nextSlot;
+}
+
+const float* ProjectileTrail::GetSlots() const
+{
+	return slots.data();
+}
+
+long long ProjectileTrail::GetTotalPointsKept() const
+{
+	return totalPointsKept;
+}
+
+unsigned int ProjectileTrail::GetGeneration() const
+{
+	return generation;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+
+const int DefaultTrailCapacity = 4096;
+
+//Fixed capacity history of the projectile's positions in OpenGL coordinates. Once full, the
+//newest point overwrites the oldest, so a long flight never grows the trail or its draw cost.
+//With a decimation of N only every Nth point handed to AddPoint is kept
+class ProjectileTrail
+{
+public:
+	explicit ProjectileTrail(int capacity = DefaultTrailCapacity, int decimation = 1);
+
+	void AddPoint(float x, float y);
+	void Clear();
+
+	int GetCapacity() const;
+	int GetPointCount() const;
+
+	//Slot of the oldest point. The points run from there to the end of the ring, then wrap to slot 0
+	int GetOldestSlot() const;
+
+	//x, y pairs for capacity + 1 slots. The extra last slot repeats slot 0, so drawing the run
+	//from the oldest slot up to and including the extra slot joins up with the wrapped part
+	const float* GetSlots() const;
+
+	//Points kept since the trail was created. The renderer compares it with what it has
+	//already uploaded to find the points that are new this frame
+	long long GetTotalPointsKept() const;
+
+	//Changes every time the trail is cleared
+	unsigned int GetGeneration() const;
+
+private:
+	std::vector<float> slots;
+	int capacity;
+	int decimation;
+	int pointCount = 0;
+	int nextSlot = 0;
+	int pointsSkipped = 0;
+	long long totalPointsKept = 0;
+	unsigned int generation = 0;
+};
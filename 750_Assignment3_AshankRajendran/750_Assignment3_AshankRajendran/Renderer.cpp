@@ -0,0 +1,518 @@
+#include "Renderer.h"
+#include "Game.h"
+#include "GLFunctions.h"
+#include "ProjectileTrail.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+const int TankOutlineSegments = 30;
+
+//glRotatef rotated the cannon with the exact value of pi rather than the game's PI
+const float DegreesToRadians = 3.14159265358979f / 180.0f;
+
+OpenGLRenderBackend::OpenGLRenderBackend(GLFWwindow* window) : window(window)
+{
+	for (int i = 0; i <= TankOutlineSegments; i++)
+	{
+		float theta = 2.0f * PI * i / TankOutlineSegments;
+		unitCircle.push_back(cos(theta));
+		unitCircle.push_back(sin(theta));
+	}
+
+	LoadGLFunctions();
+	useInstancedTanks = CreateInstancedTankPipeline();
+}
+
+//Mesh vertex: xy position in units of the tank radius, z is 1 for vertices that turn with the cannon,
+//w is 1 for vertices given directly in OpenGL units instead (the fixed size center dot).
+//Instance: xy tank center and z tank radius in OpenGL units, w cannon angle in radians
+static const char* tankVertexShaderSource = R"(
+#version 120
+attribute vec4 meshVertex;
+attribute vec4 tankInstance;
+void main()
+{
+	float angle = tankInstance.w * meshVertex.z;
+	vec2 local = meshVertex.xy * mix(tankInstance.z, 1.0, meshVertex.w);
+	local = vec2(local.x * cos(angle) - local.y * sin(angle), local.x * sin(angle) + local.y * cos(angle));
+	gl_Position = vec4(tankInstance.xy + local, 0.0, 1.0);
+}
+)";
+
+static const char* tankFragmentShaderSource = R"(
+#version 120
+void main()
+{
+	gl_FragColor = vec4(0.5, 0.5, 0.5, 1.0);
+}
+)";
+
+static GLuint CompileShader(GLenum type, const char* source)
+{
+	GLuint shader = glFunctions.CreateShader(type);
+	glFunctions.ShaderSource(shader, 1, &source, nullptr);
+	glFunctions.CompileShader(shader);
+
+	GLint compiled = GL_FALSE;
+	glFunctions.GetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	if (compiled != GL_TRUE)
+	{
+		char infoLog[1024];
+		glFunctions.GetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+		std::cerr << "failed to compile the tank shader: " << infoLog << std::endl;
+		glFunctions.DeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
+
+bool OpenGLRenderBackend::CreateInstancedTankPipeline()
+{
+	if (!glFunctions.hasInstancing)
+	{
+		return false;
+	}
+
+	GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, tankVertexShaderSource);
+	GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, tankFragmentShaderSource);
+	if (vertexShader == 0 || fragmentShader == 0)
+	{
+		return false;
+	}
+
+	tankProgram = glFunctions.CreateProgram();
+	glFunctions.AttachShader(tankProgram, vertexShader);
+	glFunctions.AttachShader(tankProgram, fragmentShader);
+	glFunctions.BindAttribLocation(tankProgram, 0, "meshVertex");
+	glFunctions.BindAttribLocation(tankProgram, 1, "tankInstance");
+	glFunctions.LinkProgram(tankProgram);
+	glFunctions.DeleteShader(vertexShader);
+	glFunctions.DeleteShader(fragmentShader);
+
+	GLint linked = GL_FALSE;
+	glFunctions.GetProgramiv(tankProgram, GL_LINK_STATUS, &linked);
+	if (linked != GL_TRUE)
+	{
+		std::cerr << "failed to link the tank shader" << std::endl;
+		return false;
+	}
+
+	std::vector<float> mesh;
+	auto addMeshVertex = [&mesh](float x, float y, float rotates, float fixedSize)
+		{
+			mesh.insert(mesh.end(), { x, y, rotates, fixedSize });
+		};
+
+	//The tank outline, as a fan of triangles around its center
+	for (int i = 0; i < TankOutlineSegments; i++)
+	{
+		addMeshVertex(0, 0, 0, 0);
+		addMeshVertex(unitCircle[2 * i], unitCircle[2 * i + 1], 0, 0);
+		addMeshVertex(unitCircle[2 * i + 2], unitCircle[2 * i + 3], 0, 0);
+	}
+
+	//The 10 pixel center dot
+	float dotHalfWidth = 5.0f / SCREENSIZE_X * 2;
+	float dotHalfHeight = 5.0f / SCREENSIZE_Y * 2;
+	float dot[4][2] = { { -dotHalfWidth, -dotHalfHeight }, { dotHalfWidth, -dotHalfHeight }, { dotHalfWidth, dotHalfHeight }, { -dotHalfWidth, dotHalfHeight } };
+	for (int corner : { 0, 1, 2, 0, 2, 3 })
+	{
+		addMeshVertex(dot[corner][0], dot[corner][1], 0, 1);
+	}
+
+	//The cannon, pointing along the x axis before it is rotated
+	float cannon[4][2] = { { 0, -0.25f }, { 1.5f, -0.25f }, { 1.5f, 0.25f }, { 0, 0.25f } };
+	for (int corner : { 0, 1, 2, 0, 2, 3 })
+	{
+		addMeshVertex(cannon[corner][0], cannon[corner][1], 1, 0);
+	}
+
+	tankMeshVertexCount = (int)mesh.size() / 4;
+
+	glFunctions.GenBuffers(1, &tankMeshBuffer);
+	glFunctions.BindBuffer(GL_ARRAY_BUFFER, tankMeshBuffer);
+	glFunctions.BufferData(GL_ARRAY_BUFFER, mesh.size() * sizeof(float), mesh.data(), GL_STATIC_DRAW);
+
+	glFunctions.GenBuffers(1, &tankInstanceBuffer);
+	glFunctions.BindBuffer(GL_ARRAY_BUFFER, 0);
+	return true;
+}
+
+//Draws every live tank with a single instanced draw call
+void OpenGLRenderBackend::DrawTanksInstanced(const Match& match)
+{
+	tankInstances.clear();
+	for (int i = 0; i < match.numberOfTanks; i++)
+	{
+		const Tank& tank = match.allTanks[i];
+		if (tank.isAlive)
+		{
+			tankInstances.push_back(NormalizeCoordinates_X(tank.xCoordinate));
+			tankInstances.push_back(NormalizeCoordinates_Y(tank.yCoordinate));
+			tankInstances.push_back((tank.tankSize / (float)SCREENSIZE_X) * 2);
+			tankInstances.push_back(tank.angle * DegreesToRadians);
+		}
+	}
+
+	int instanceCount = (int)tankInstances.size() / 4;
+	if (instanceCount == 0)
+	{
+		return;
+	}
+
+	glFunctions.UseProgram(tankProgram);
+
+	glFunctions.BindBuffer(GL_ARRAY_BUFFER, tankMeshBuffer);
+	glFunctions.EnableVertexAttribArray(0);
+	glFunctions.VertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+	//Orphan last frame's instance data rather than waiting for the GPU to finish with it
+	glFunctions.BindBuffer(GL_ARRAY_BUFFER, tankInstanceBuffer);
+	glFunctions.BufferData(GL_ARRAY_BUFFER, tankInstances.size() * sizeof(float), tankInstances.data(), GL_STREAM_DRAW);
+	glFunctions.EnableVertexAttribArray(1);
+	glFunctions.VertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+	glFunctions.VertexAttribDivisor(1, 1);
+
+	glFunctions.DrawArraysInstanced(GL_TRIANGLES, 0, tankMeshVertexCount, instanceCount);
+
+	glFunctions.VertexAttribDivisor(1, 0);
+	glFunctions.DisableVertexAttribArray(1);
+	glFunctions.DisableVertexAttribArray(0);
+	glFunctions.BindBuffer(GL_ARRAY_BUFFER, 0);
+	glFunctions.UseProgram(0);
+}
+
+void OpenGLRenderBackend::AddVertex(float x, float y, Color color)
+{
+	vertices.push_back({ x, y, color.red, color.green, color.blue });
+}
+
+//Adds a quad with corners in winding order as two triangles
+void OpenGLRenderBackend::AddQuad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3, Color color)
+{
+	AddVertex(x0, y0, color);
+	AddVertex(x1, y1, color);
+	AddVertex(x2, y2, color);
+
+	AddVertex(x0, y0, color);
+	AddVertex(x2, y2, color);
+	AddVertex(x3, y3, color);
+}
+
+// Add a Tank
+void OpenGLRenderBackend::AddTank(const Tank& tank)
+{
+	const Color tankColor = { 0.5, 0.5, 0.5 };
+
+	float tankCenter_x = NormalizeCoordinates_X(tank.xCoordinate);
+	float tankCenter_y = NormalizeCoordinates_Y(tank.yCoordinate);
+
+	// Scale tank size to OpenGL coordinates
+	float normalizedSize = (tank.tankSize / (float)SCREENSIZE_X) * 2;
+
+	//Add the Tank as a fan of triangles around its center
+	for (int i = 0; i < TankOutlineSegments; i++)
+	{
+		AddVertex(tankCenter_x, tankCenter_y, tankColor);
+		AddVertex(tankCenter_x + normalizedSize * unitCircle[2 * i], tankCenter_y + normalizedSize * unitCircle[2 * i + 1], tankColor);
+		AddVertex(tankCenter_x + normalizedSize * unitCircle[2 * i + 2], tankCenter_y + normalizedSize * unitCircle[2 * i + 3], tankColor);
+	}
+
+	//Add the tank's cannon, rotated about the tank center on the CPU
+	float cosAngle = cos(tank.angle * DegreesToRadians);
+	float sinAngle = sin(tank.angle * DegreesToRadians);
+
+	float length = normalizedSize * 1.5f;
+	float halfWidth = 0.25f * normalizedSize;
+
+	auto rotatedX = [&](float x, float y) { return tankCenter_x + x * cosAngle - y * sinAngle; };
+	auto rotatedY = [&](float x, float y) { return tankCenter_y + x * sinAngle + y * cosAngle; };
+
+	AddQuad(rotatedX(0, -halfWidth), rotatedY(0, -halfWidth),
+		rotatedX(length, -halfWidth), rotatedY(length, -halfWidth),
+		rotatedX(length, halfWidth), rotatedY(length, halfWidth),
+		rotatedX(0, halfWidth), rotatedY(0, halfWidth),
+		tankColor);
+}
+
+void OpenGLRenderBackend::AddTankCenter(const Tank& tank)
+{
+	AddVertex(NormalizeCoordinates_X(tank.xCoordinate), NormalizeCoordinates_Y(tank.yCoordinate), { 0.5, 0.5, 0.5 });
+}
+
+void OpenGLRenderBackend::AddPowerBar(const Tank& currentTank, float horizontalScaleModifier)
+{
+	float left = NormalizeCoordinates_X(currentTank.xCoordinate - currentTank.tankSize);
+	float bottom = NormalizeCoordinates_Y(currentTank.yCoordinate + currentTank.tankSize + 1);
+	float width = (NormalizeCoordinates_X(currentTank.tankSize * 2) + 1) * horizontalScaleModifier;
+	float height = 0.025f;
+
+	AddQuad(left, bottom, left + width, bottom, left + width, bottom + height, left, bottom + height, { 1, 0.5, 0 });
+}
+
+void OpenGLRenderBackend::UploadNewTrailPoints(const ProjectileTrail& trail, TrailUpload& upload)
+{
+	int capacity = trail.GetCapacity();
+
+	glFunctions.BindBuffer(GL_ARRAY_BUFFER, upload.buffer);
+	if (upload.capacity != capacity)
+	{
+		glFunctions.BufferData(GL_ARRAY_BUFFER, (capacity + 1) * 2 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+		upload.capacity = capacity;
+		upload.generationUploaded = trail.GetGeneration() - 1;
+	}
+
+	//After a clear every point still in the ring is new
+	if (upload.generationUploaded != trail.GetGeneration())
+	{
+		upload.generationUploaded = trail.GetGeneration();
+		upload.pointsUploaded = trail.GetTotalPointsKept() - trail.GetPointCount();
+	}
+
+	long long newPoints = trail.GetTotalPointsKept() - upload.pointsUploaded;
+	if (newPoints > trail.GetPointCount())
+	{
+		newPoints = trail.GetPointCount();
+	}
+	upload.pointsUploaded = trail.GetTotalPointsKept();
+
+	//The new points are the newest ones in the ring and may wrap past its end
+	int firstSlot = (trail.GetOldestSlot() + trail.GetPointCount() - (int)newPoints) % capacity;
+	int slotsBeforeWrap = (int)newPoints < capacity - firstSlot ? (int)newPoints : capacity - firstSlot;
+	int slotsAfterWrap = (int)newPoints - slotsBeforeWrap;
+
+	const float* slots = trail.GetSlots();
+	if (slotsBeforeWrap > 0)
+	{
+		glFunctions.BufferSubData(GL_ARRAY_BUFFER, firstSlot * 2 * sizeof(float), slotsBeforeWrap * 2 * sizeof(float), slots + firstSlot * 2);
+	}
+	if (slotsAfterWrap > 0)
+	{
+		glFunctions.BufferSubData(GL_ARRAY_BUFFER, 0, slotsAfterWrap * 2 * sizeof(float), slots);
+	}
+
+	//Slot 0 is repeated after the last slot so the two halves of a wrapped ring join up
+	if (newPoints > 0 && (firstSlot == 0 || slotsAfterWrap > 0))
+	{
+		glFunctions.BufferSubData(GL_ARRAY_BUFFER, capacity * 2 * sizeof(float), 2 * sizeof(float), slots + capacity * 2);
+	}
+}
+
+//Draw a line trail for the projectile's path
+void OpenGLRenderBackend::DrawProjectileTrail(const ProjectileTrail& trail, TrailUpload& upload)
+{
+	int pointCount = trail.GetPointCount();
+	if (pointCount < 2)
+	{
+		return;
+	}
+
+	if (glFunctions.hasBufferObjects)
+	{
+		if (upload.buffer == 0)
+		{
+			glFunctions.GenBuffers(1, &upload.buffer);
+		}
+		UploadNewTrailPoints(trail, upload);
+		glVertexPointer(2, GL_FLOAT, 0, nullptr);
+	}
+	else
+	{
+		glVertexPointer(2, GL_FLOAT, 0, trail.GetSlots());
+	}
+
+	glColor3f(0, 0, 0);
+
+	//Oldest to the end of the ring (through the repeat of slot 0), then the part that wrapped
+	int oldestSlot = trail.GetOldestSlot();
+	if (oldestSlot == 0)
+	{
+		glDrawArrays(GL_LINE_STRIP, 0, pointCount);
+	}
+	else
+	{
+		glDrawArrays(GL_LINE_STRIP, oldestSlot, trail.GetCapacity() - oldestSlot + 1);
+		glDrawArrays(GL_LINE_STRIP, 0, oldestSlot);
+	}
+
+	if (glFunctions.hasBufferObjects)
+	{
+		glFunctions.BindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+}
+
+void OpenGLRenderBackend::DrawTerrain(const Terrain& terrain)
+{
+	int width = terrain.GetWidth();
+	if (width == 0)
+	{
+		return;
+	}
+
+	//Work out which columns changed. After a new match, or more carves than the terrain remembers, that is all of them
+	bool isWholeTerrain = terrainUpload.width != width || terrainUpload.generationUploaded != terrain.GetGeneration();
+	int firstColumn = width;
+	int lastColumn = -1;
+	for (long long carve = terrainUpload.carvesUploaded; carve < terrain.GetCarveCount() && !isWholeTerrain; carve++)
+	{
+		int carveFirst, carveLast;
+		if (!terrain.GetCarvedColumns(carve, carveFirst, carveLast))
+		{
+			isWholeTerrain = true;
+			break;
+		}
+		firstColumn = min(firstColumn, carveFirst);
+		lastColumn = max(lastColumn, carveLast);
+	}
+	if (isWholeTerrain)
+	{
+		terrainVertices.resize((width + 1) * 4);
+		firstColumn = 0;
+		lastColumn = width - 1;
+	}
+	terrainUpload.width = width;
+	terrainUpload.generationUploaded = terrain.GetGeneration();
+	terrainUpload.carvesUploaded = terrain.GetCarveCount();
+
+	//The last column's height is used again for the right edge of the world
+	int lastEdge = lastColumn == width - 1 ? width : lastColumn;
+	const float* heights = terrain.GetHeights();
+	for (int edge = firstColumn; edge <= lastEdge; edge++)
+	{
+		float* pair = &terrainVertices[edge * 4];
+		pair[0] = pair[2] = NormalizeCoordinates_X((float)edge);
+		pair[1] = NormalizeCoordinates_Y(0);
+		pair[3] = NormalizeCoordinates_Y(heights[min(edge, width - 1)]);
+	}
+
+	if (glFunctions.hasBufferObjects)
+	{
+		if (terrainUpload.buffer == 0)
+		{
+			glFunctions.GenBuffers(1, &terrainUpload.buffer);
+			isWholeTerrain = true;
+		}
+		glFunctions.BindBuffer(GL_ARRAY_BUFFER, terrainUpload.buffer);
+		if (isWholeTerrain)
+		{
+			glFunctions.BufferData(GL_ARRAY_BUFFER, terrainVertices.size() * sizeof(float), terrainVertices.data(), GL_DYNAMIC_DRAW);
+		}
+		else if (lastEdge >= firstColumn)
+		{
+			glFunctions.BufferSubData(GL_ARRAY_BUFFER, firstColumn * 4 * sizeof(float), (lastEdge - firstColumn + 1) * 4 * sizeof(float), &terrainVertices[firstColumn * 4]);
+		}
+		glVertexPointer(2, GL_FLOAT, 0, nullptr);
+	}
+	else
+	{
+		glVertexPointer(2, GL_FLOAT, 0, terrainVertices.data());
+	}
+
+	glColor3f(0, 0.55f, 0);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, (width + 1) * 2);
+
+	if (glFunctions.hasBufferObjects)
+	{
+		glFunctions.BindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+}
+
+void OpenGLRenderBackend::DrawFrame(const Match& match, float interpolation)
+{
+	vertices.clear();
+
+	//Point at each projectile's position, blended between its last two simulated positions
+	const ProjectilePool& projectiles = match.projectiles;
+	const int* activeProjectiles = projectiles.GetActiveIndices();
+	int projectileFirst = (int)vertices.size();
+	for (int j = 0; j < projectiles.GetActiveCount(); j++)
+	{
+		int i = activeProjectiles[j];
+		float x = projectiles.previousPositionX[i] + (projectiles.positionX[i] - projectiles.previousPositionX[i]) * interpolation;
+		float y = projectiles.previousPositionY[i] + (projectiles.positionY[i] - projectiles.previousPositionY[i]) * interpolation;
+		AddVertex(NormalizeCoordinates_X(x), NormalizeCoordinates_Y(y), { 1, 0, 0 });
+	}
+	int projectileCount = (int)vertices.size() - projectileFirst;
+
+	//Triangles for the power bar and, without instancing, every tank with its cannon
+	int shapesFirst = (int)vertices.size();
+	if (match.isTankPoweringUp)
+	{
+		const Tank& currentTank = match.allTanks[match.currentPlayer];
+		AddPowerBar(currentTank, (currentTank.power - TankMinPower) / (TankMaxPower - TankMinPower));
+	}
+	for (int i = 0; i < match.numberOfTanks && !useInstancedTanks; i++)
+	{
+		if (match.allTanks[i].isAlive)
+		{
+			AddTank(match.allTanks[i]);
+		}
+	}
+	int shapesCount = (int)vertices.size() - shapesFirst;
+
+	//Points marking the tank centers, which the instanced mesh already includes
+	int centersFirst = (int)vertices.size();
+	for (int i = 0; i < match.numberOfTanks && !useInstancedTanks; i++)
+	{
+		if (match.allTanks[i].isAlive)
+		{
+			AddTankCenter(match.allTanks[i]);
+		}
+	}
+	int centersCount = (int)vertices.size() - centersFirst;
+
+	glClearColor(1.0, 1.0, 1.0, 0.0);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+
+	if ((int)trailUploads.size() < projectiles.GetCapacity())
+	{
+		trailUploads.resize(projectiles.GetCapacity());
+	}
+	for (int j = 0; j < projectiles.GetActiveCount(); j++)
+	{
+		int i = activeProjectiles[j];
+		DrawProjectileTrail(projectiles.trails[i], trailUploads[i]);
+	}
+
+	//With instanced tanks and nothing in flight there may be no vertices at all
+	if (!vertices.empty())
+	{
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].x);
+		glColorPointer(3, GL_FLOAT, sizeof(Vertex), &vertices[0].red);
+
+		if (projectileCount > 0)
+		{
+			glPointSize(5.0f);
+			glDrawArrays(GL_POINTS, projectileFirst, projectileCount);
+		}
+
+		glDrawArrays(GL_TRIANGLES, shapesFirst, shapesCount);
+
+		if (centersCount > 0)
+		{
+			glPointSize(10);
+			glDrawArrays(GL_POINTS, centersFirst, centersCount);
+		}
+
+		glDisableClientState(GL_COLOR_ARRAY);
+	}
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	if (useInstancedTanks)
+	{
+		DrawTanksInstanced(match);
+	}
+
+	//The ground goes last so it covers the lower half of the tanks
+	glEnableClientState(GL_VERTEX_ARRAY);
+	DrawTerrain(match.terrain);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	glfwSwapBuffers(window);
+}
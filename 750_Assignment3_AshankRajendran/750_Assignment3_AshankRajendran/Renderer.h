@@ -0,0 +1,94 @@
+#pragma once
+#include "Backends.h"
+#include <vector>
+
+struct GLFWwindow;
+struct Tank;
+class ProjectileTrail;
+class Terrain;
+
+//Draws the game state for the windowed game. Each frame is built on the CPU into one vertex
+//buffer and sent with a fixed handful of glDrawArrays calls, however many tanks or trail points there are
+class OpenGLRenderBackend : public RenderBackend
+{
+public:
+	explicit OpenGLRenderBackend(GLFWwindow* window);
+
+	void DrawFrame(const Match& match, float interpolation) override;
+
+private:
+	struct Vertex
+	{
+		float x, y;
+		float red, green, blue;
+	};
+
+	struct Color
+	{
+		float red, green, blue;
+	};
+
+	//GPU copy of one projectile trail's ring, kept in step with it a few points at a time
+	struct TrailUpload
+	{
+		unsigned int buffer = 0;
+		int capacity = 0;
+		long long pointsUploaded = 0;
+		unsigned int generationUploaded = 0;
+	};
+
+	//GPU copy of the terrain as a triangle strip, a pair of vertices per column, kept in step with it
+	//one carve at a time
+	struct TerrainUpload
+	{
+		unsigned int buffer = 0;
+		int width = 0;
+		long long carvesUploaded = 0;
+		unsigned int generationUploaded = 0;
+	};
+
+	void AddVertex(float x, float y, Color color);
+	void AddQuad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3, Color color);
+
+	void AddTank(const Tank& tank);
+	void AddTankCenter(const Tank& tank);
+	void AddPowerBar(const Tank& currentTank, float horizontalScaleModifier);
+
+	//Uploads the tank mesh and builds the shader for DrawTanksInstanced. Returns false if the
+	//context cannot do instancing, in which case tanks are added to the frame's vertex buffer instead
+	bool CreateInstancedTankPipeline();
+	void DrawTanksInstanced(const Match& match);
+
+	//Copies only the trail points added since the last frame into the trail buffer, then draws the trail
+	void UploadNewTrailPoints(const ProjectileTrail& trail, TrailUpload& upload);
+	void DrawProjectileTrail(const ProjectileTrail& trail, TrailUpload& upload);
+
+	//Rebuilds and sends only the columns carved since the last frame, then draws the ground
+	void DrawTerrain(const Terrain& terrain);
+
+	GLFWwindow* window;
+
+	//Reused every frame, so it stops allocating once it has grown to fit the busiest frame
+	std::vector<Vertex> vertices;
+
+	//cos/sin pairs of the tank outline, worked out once instead of for every tank on every frame
+	std::vector<float> unitCircle;
+
+	//Instanced tank path. The mesh holds one tank outline, center dot and cannon and is uploaded once;
+	//each frame only the center, radius and cannon angle of every live tank is sent.
+	//The GL objects are released along with the context by glfwTerminate
+	bool useInstancedTanks = false;
+	unsigned int tankProgram = 0;
+	unsigned int tankMeshBuffer = 0;
+	unsigned int tankInstanceBuffer = 0;
+	int tankMeshVertexCount = 0;
+	std::vector<float> tankInstances;
+
+	//One per projectile slot, grown to the pool's capacity. Without buffer objects the trails are
+	//drawn straight from the match's rings instead
+	std::vector<TrailUpload> trailUploads;
+
+	//x, y of the bottom then the top of each column's left edge, and of the right edge of the last column
+	std::vector<float> terrainVertices;
+	TerrainUpload terrainUpload;
+};
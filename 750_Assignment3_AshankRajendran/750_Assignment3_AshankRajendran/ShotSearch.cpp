@@ -0,0 +1,247 @@
+#include "ShotSearch.h"
+#include "ComputerPlayer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+using namespace std;
+
+//Candidates a worker takes at a time. Enough that the shared counter is rarely touched, few enough
+//that the deadline is checked every millisecond or so
+static const int ChunkSize = 64;
+
+//How far around the solved shot the local half of the candidates go, in thousandths of a degree and of the solved power
+static const int LocalAngleSpread = 4000;
+static const int LocalPowerSpread = 60;
+
+//Points for each tank destroyed, on top of a point for each bit of health taken off. Health the shooter
+//loses counts SelfDamageWeight times against the shot, and destroying itself outweighs anything the shot
+//could do to the others
+static const int64_t KillScore = 1000;
+static const int64_t SelfDamageWeight = 4;
+static const int64_t SelfDestroyedScore = -1000000;
+
+//A shell leaving the sides of the world scores as badly as the furthest miss
+static const int64_t LostShellScore = -2 * (SCREENSIZE_X + SCREENSIZE_Y);
+
+//Spreads the bits of the turn's seed and a candidate's index, so every candidate can be drawn on its own
+//with integer math only. The SplitMix64 finalizer
+static uint64_t MixBits(uint64_t value)
+{
+	value += 0x9e3779b97f4a7c15ULL;
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return value ^ (value >> 31);
+}
+
+ShotSearch::ShotSearch(const ShotSearchOptions& options)
+	: options(options)
+{
+	int numberOfThreads = options.numberOfThreads > 0 ? options.numberOfThreads : (int)thread::hardware_concurrency();
+	if (numberOfThreads > 1)
+	{
+		threadPool = make_unique<ThreadPool>(numberOfThreads);
+	}
+	workers.resize(max(numberOfThreads, 1));
+}
+
+int64_t ShotSearch::ScoreShot(const Match& match, Worker& worker, int targetIndex, int candidate) const
+{
+	int numberOfShells = PredictShot(match, worker.tankStore, worker.tanksInReach.data(),
+		candidateAngles[candidate] / 1000.0f, candidatePowers[candidate] / 1000.0f, worker.predictions.data());
+
+	const Tank& target = match.allTanks[targetIndex];
+	int64_t score = 0;
+	for (int s = 0; s < numberOfShells; s++)
+	{
+		const ShellPrediction& prediction = worker.predictions[s];
+		if (!prediction.isExploding)
+		{
+			score += LostShellScore;
+			continue;
+		}
+
+		bool isDamaging = false;
+		int numberInRadius = worker.tankStore.FindTanksInRadius(prediction.impactX, prediction.impactY, BlastRadius, worker.tanksInReach.data());
+		for (int j = 0; j < numberInRadius; j++)
+		{
+			int i = worker.tanksInReach[j];
+			int damage = GetBlastDamage(match.allTanks[i], prediction.impactX, prediction.impactY, i == prediction.targetIndex);
+			if (damage == 0)
+			{
+				continue;
+			}
+			if (worker.damage[i] == 0)
+			{
+				worker.damagedTanks.push_back(i);
+			}
+			worker.damage[i] += damage;
+			isDamaging = true;
+		}
+
+		//A miss is only as bad as it is far from the target, so the search still closes in when nothing is in reach
+		if (!isDamaging)
+		{
+			score -= llabs(llround(prediction.impactX) - target.xCoordinate) + llabs(llround(prediction.impactY) - target.yCoordinate);
+		}
+	}
+
+	//The shells are scored as if they all landed on the tanks as they are now
+	for (int i : worker.damagedTanks)
+	{
+		const Tank& tank = match.allTanks[i];
+		int healthLost = min(worker.damage[i], tank.health);
+		bool isDestroyed = worker.damage[i] >= tank.health;
+		worker.damage[i] = 0;
+
+		if (i == match.currentPlayer)
+		{
+			score -= SelfDamageWeight * healthLost;
+			score += isDestroyed ? SelfDestroyedScore : 0;
+		}
+		else
+		{
+			score += healthLost;
+			score += isDestroyed ? KillScore : 0;
+		}
+	}
+	worker.damagedTanks.clear();
+	return score;
+}
+
+void ShotSearch::SearchCandidates(const Match& match, Worker& worker, int targetIndex)
+{
+	int numberOfCandidates = (int)candidateAngles.size();
+	while (true)
+	{
+		if (isTimeLimited && worker.candidatesTried > 0 && chrono::steady_clock::now() > deadline)
+		{
+			return;
+		}
+
+		int first = nextCandidate.fetch_add(ChunkSize);
+		if (first >= numberOfCandidates)
+		{
+			return;
+		}
+
+		int last = min(first + ChunkSize, numberOfCandidates);
+		for (int candidate = first; candidate < last; candidate++)
+		{
+			//A tie goes to the earlier candidate, so the pick does not depend on which worker tried what
+			int64_t score = ScoreShot(match, worker, targetIndex, candidate);
+			if (worker.bestCandidate == -1 || score > worker.bestScore || (score == worker.bestScore && candidate < worker.bestCandidate))
+			{
+				worker.bestCandidate = candidate;
+				worker.bestScore = score;
+			}
+			worker.candidatesTried++;
+		}
+	}
+}
+
+int ShotSearch::AimCurrentPlayer(Match& match)
+{
+	int targetIndex = ChooseTarget(match, match.currentPlayer);
+	if (targetIndex == -1)
+	{
+		return 0;
+	}
+
+	//The solved shot is the first candidate and the centre of the local ones. Aiming without error draws nothing
+	AimAt(match, targetIndex, HardAimError);
+	Tank& shooter = match.allTanks[match.currentPlayer];
+	int solvedAngle = ToMillidegrees(shooter.angle);
+	int solvedPower = (int)llround(shooter.power * 1000);
+
+	//One draw per turn, from which every candidate is worked out with integer math, so deterministic
+	//matches try the same shots everywhere
+	uint64_t seed = (uint64_t)match.randomGenerator() << 32;
+
+	const int minAngle = ToMillidegrees(TankMinAngle);
+	const int maxAngle = ToMillidegrees(TankMaxAngle);
+	const int minPower = (int)(TankMinPower * 1000);
+	const int maxPower = (int)(TankMaxPower * 1000);
+	int localPowerSpread = solvedPower * LocalPowerSpread / 1000;
+
+	int numberOfCandidates = max(options.numberOfCandidates, 1);
+	candidateAngles.resize(numberOfCandidates);
+	candidatePowers.resize(numberOfCandidates);
+	candidateAngles[0] = solvedAngle;
+	candidatePowers[0] = solvedPower;
+	for (int candidate = 1; candidate < numberOfCandidates; candidate++)
+	{
+		uint64_t bits = MixBits(seed | (uint64_t)candidate);
+		unsigned int angleBits = (unsigned int)bits;
+		unsigned int powerBits = (unsigned int)(bits >> 32);
+
+		int angle, power;
+		if (candidate % 2 == 1)
+		{
+			angle = minAngle + (int)(angleBits % (unsigned int)(maxAngle - minAngle + 1));
+			power = minPower + (int)(powerBits % (unsigned int)(maxPower - minPower + 1));
+		}
+		else
+		{
+			angle = solvedAngle + (int)(angleBits % (2 * LocalAngleSpread + 1)) - LocalAngleSpread;
+			power = solvedPower + (int)(powerBits % (2 * (unsigned int)localPowerSpread + 1)) - localPowerSpread;
+		}
+		candidateAngles[candidate] = min(max(angle, minAngle), maxAngle);
+		candidatePowers[candidate] = min(max(power, minPower), maxPower);
+	}
+
+	//Every worker gets its own copy of the tank store, as the queries use it for scratch space
+	int numberOfShells = match.shellsPerShot > 1 ? match.shellsPerShot : 1;
+	for (Worker& worker : workers)
+	{
+		worker.tankStore = match.tankStore;
+		worker.tanksInReach.resize(match.numberOfTanks);
+		worker.predictions.resize(numberOfShells);
+		worker.damage.assign(match.numberOfTanks, 0);
+		worker.bestCandidate = -1;
+		worker.candidatesTried = 0;
+	}
+
+	nextCandidate = 0;
+	isTimeLimited = !match.isDeterministic;
+	deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(options.timeBudgetSeconds));
+
+	if (threadPool)
+	{
+		for (Worker& worker : workers)
+		{
+			Worker* workerPointer = &worker;
+			threadPool->Submit([this, &match, workerPointer, targetIndex]()
+				{
+					SearchCandidates(match, *workerPointer, targetIndex);
+				});
+		}
+		threadPool->WaitForAll();
+	}
+	else
+	{
+		SearchCandidates(match, workers[0], targetIndex);
+	}
+
+	int bestCandidate = -1;
+	int64_t bestScore = 0;
+	int candidatesTried = 0;
+	for (const Worker& worker : workers)
+	{
+		candidatesTried += worker.candidatesTried;
+		if (worker.bestCandidate != -1 && (bestCandidate == -1 || worker.bestScore > bestScore || (worker.bestScore == bestScore && worker.bestCandidate < bestCandidate)))
+		{
+			bestCandidate = worker.bestCandidate;
+			bestScore = worker.bestScore;
+		}
+	}
+
+	shooter.angle = candidateAngles[bestCandidate] / 1000.0f;
+	shooter.power = candidatePowers[bestCandidate] / 1000.0f;
+
+	LOG_DEBUG("Tank " << match.currentPlayer + 1 << " tries " << candidatesTried << " shots and picks angle " << shooter.angle
+		<< " and power " << shooter.power << ", scoring " << bestScore);
+	return candidatesTried;
+}
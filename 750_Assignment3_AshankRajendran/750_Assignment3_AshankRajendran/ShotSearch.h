@@ -0,0 +1,74 @@
+#pragma once
+#include "Game.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct ShotSearchOptions
+{
+	//Shots tried per turn. Half are spread over every angle and power a tank can fire at, the other half
+	//around the shot AimAt solves for the target ChooseTarget picks, which is always tried first
+	int numberOfCandidates = 4096;
+
+	//Wall clock seconds a turn may spend trying shots before it takes the best one found so far.
+	//Deterministic matches try every candidate however long it takes, so they pick the same shot everywhere
+	double timeBudgetSeconds = 0.01;
+
+	//0 threads means one per hardware thread. With 1 the shots are tried on the calling thread, which
+	//is what batch runs want, as they already keep every core busy with whole matches
+	int numberOfThreads = 0;
+};
+
+//Computer player that tries thousands of shots each turn instead of solving for a single one. Every
+//candidate is flown with PredictShot, exactly as FireProjectile would fly it over the real terrain and
+//tanks, then scored by the health its blasts take off the other tanks, with a bonus for each one destroyed
+//and a heavy penalty for hurting the shooter. Shots that hit nothing score by how far from the target
+//they land. The candidates are shared out across a thread pool, each thread with its own copy of the
+//tank store for the queries, so a stronger machine tries more of them within the time budget
+class ShotSearch
+{
+public:
+	explicit ShotSearch(const ShotSearchOptions& options = ShotSearchOptions());
+
+	ShotSearch(const ShotSearch&) = delete;
+	ShotSearch& operator=(const ShotSearch&) = delete;
+
+	//Sets the current player's angle and power to the best shot found, without firing. Call FireProjectile
+	//next to take it. Returns how many shots were tried
+	int AimCurrentPlayer(Match& match);
+
+private:
+	struct Worker
+	{
+		TankStore tankStore;
+		std::vector<int> tanksInReach;
+		std::vector<ShellPrediction> predictions;
+
+		//Health each tank would lose to the shot being scored, and which tanks that is. All 0 between shots
+		std::vector<int> damage;
+		std::vector<int> damagedTanks;
+
+		int bestCandidate = -1;
+		int64_t bestScore = 0;
+		int candidatesTried = 0;
+	};
+
+	int64_t ScoreShot(const Match& match, Worker& worker, int targetIndex, int candidate) const;
+	void SearchCandidates(const Match& match, Worker& worker, int targetIndex);
+
+	ShotSearchOptions options;
+	std::unique_ptr<ThreadPool> threadPool;
+	std::vector<Worker> workers;
+
+	//This turn's candidates, in thousandths of a degree and thousandths of a pixel per second
+	std::vector<int> candidateAngles;
+	std::vector<int> candidatePowers;
+
+	//Workers take the candidates ChunkSize at a time from here, and stop taking them once the deadline passes
+	std::atomic<int> nextCandidate{ 0 };
+	bool isTimeLimited = false;
+	std::chrono::steady_clock::time_point deadline;
+};
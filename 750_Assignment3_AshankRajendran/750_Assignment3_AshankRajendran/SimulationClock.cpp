@@ -0,0 +1,43 @@
+#include "SimulationClock.h"
+
+SimulationClock::SimulationClock(double ticksPerSecond, int maxTicksPerFrame)
+	: secondsPerTick(1.0 / ticksPerSecond), maxTicksPerFrame(maxTicksPerFrame)
+{
+}
+
+int SimulationClock::Advance(double frameSeconds)
+{
+	if (frameSeconds < 0)
+	{
+		frameSeconds = 0;
+	}
+	accumulatedSeconds += frameSeconds * speed;
+
+	int ticks = (int)(accumulatedSeconds / secondsPerTick);
+	if (ticks > maxTicksPerFrame)
+	{
+		//Too far behind to catch up, so drop the backlog instead of trying
+		ticks = maxTicksPerFrame;
+		accumulatedSeconds = 0;
+	}
+	else
+	{
+		accumulatedSeconds -= ticks * secondsPerTick;
+	}
+	return ticks;
+}
+
+float SimulationClock::GetInterpolation() const
+{
+	return (float)(accumulatedSeconds / secondsPerTick);
+}
+
+void SimulationClock::SetSpeed(double newSpeed)
+{
+	speed = newSpeed;
+}
+
+double SimulationClock::GetSpeed() const
+{
+	return speed;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+//Turns wall clock frame times into a whole number of fixed simulation ticks, so the game plays
+//the same at any frame rate. Time left over between ticks is kept for the next frame and exposed
+//as an interpolation factor for drawing in between the last two ticks
+class SimulationClock
+{
+public:
+	//ticksPerSecond is the tick rate at a speed of 1. No more than maxTicksPerFrame ticks are
+	//run for one frame, so a long stall cannot snowball into ever longer frames
+	SimulationClock(double ticksPerSecond, int maxTicksPerFrame);
+
+	//Adds the wall clock time since the last frame and returns the number of ticks to run now
+	int Advance(double frameSeconds);
+
+	//How far between the last tick and the next one the current frame is, from 0 to 1
+	float GetInterpolation() const;
+
+	//Multiplies the tick rate, above 1 to fast forward the simulation and below 1 to slow it down
+	void SetSpeed(double newSpeed);
+	double GetSpeed() const;
+
+private:
+	double secondsPerTick;
+	int maxTicksPerFrame;
+	double speed = 1;
+	double accumulatedSeconds = 0;
+};
@@ -0,0 +1,547 @@
+#include "TankStore.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined (_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined (TANKSTORE_USE_AVX2)
+#include <immintrin.h>
+#elif defined (TANKSTORE_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+//Index of the lowest set bit. bits must not be 0
+static int CountTrailingZeros(uint64_t bits)
+{
+#if defined (_MSC_VER) && defined (_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return (int)index;
+#elif defined (_MSC_VER)
+	unsigned long index;
+	if (_BitScanForward(&index, (unsigned long)bits))
+	{
+		return (int)index;
+	}
+	_BitScanForward(&index, (unsigned long)(bits >> 32));
+	return (int)index + 32;
+#else
+	return __builtin_ctzll(bits);
+#endif
+}
+
+//Extra reach, in pixels, so float rounding in the quick test never rules out a tank the exact test would hit
+static const float ReachMargin = 1;
+
+void TankStore::Reset(int numberOfTanks, int worldWidth, int worldHeight)
+{
+	this->numberOfTanks = numberOfTanks;
+	numberAlive = 0;
+
+	int paddedSize = (numberOfTanks + TankStoreLanes - 1) / TankStoreLanes * TankStoreLanes;
+	x.assign(paddedSize, 0.f);
+	y.assign(paddedSize, 0.f);
+	radius.assign(paddedSize, 0.f);
+	aliveMask.assign(paddedSize, 0);
+
+	numberOfColumns = max(1, (worldWidth + TankGridCellSize - 1) / TankGridCellSize);
+	numberOfRows = max(1, (worldHeight + TankGridCellSize - 1) / TankGridCellSize);
+	cellStart.assign(numberOfColumns * numberOfRows, 0);
+	cellCount.assign(numberOfColumns * numberOfRows, 0);
+	cellTanks.clear();
+	tankCells.assign(numberOfTanks, -1);
+	isGridStale = true;
+
+	tankSlots.assign(numberOfTanks, -1);
+	found.resize(max(numberOfTanks, TankStoreLanes));
+	foundBits.assign((numberOfTanks + 63) / 64, 0);
+}
+
+void TankStore::SetTank(int index, float x, float y, float radius)
+{
+	this->x[index] = x;
+	this->y[index] = y;
+	this->radius[index] = radius;
+	SetAlive(index, true);
+	isGridStale = true;
+}
+
+void TankStore::MoveTank(int index, float x, float y)
+{
+	this->x[index] = x;
+	this->y[index] = y;
+	if (aliveMask[index] == 0 || isGridStale)
+	{
+		return;
+	}
+	cellTankX[tankSlots[index]] = x;
+	cellTankY[tankSlots[index]] = y;
+
+	float drift = GetDistanceFromCell(index, tankCells[index]);
+	if (drift > TankGridCellSize)
+	{
+		isGridStale = true;
+	}
+	maxDrift = max(maxDrift, drift);
+}
+
+void TankStore::SetAlive(int index, bool isAlive)
+{
+	if ((aliveMask[index] != 0) == isAlive)
+	{
+		return;
+	}
+	aliveMask[index] = isAlive ? -1 : 0;
+	numberAlive += isAlive ? 1 : -1;
+
+	if (isAlive || isGridStale)
+	{
+		isGridStale = true;
+		return;
+	}
+
+	//Swap the last tank of its cell into its slot
+	int cell = tankCells[index];
+	int slot = tankSlots[index];
+	int last = cellStart[cell] + --cellCount[cell];
+	int moved = cellTanks[last];
+	cellTanks[slot] = moved;
+	cellTankX[slot] = cellTankX[last];
+	cellTankY[slot] = cellTankY[last];
+	cellTankRadius[slot] = cellTankRadius[last];
+	tankSlots[moved] = slot;
+}
+
+int TankStore::GetNumberOfTanks() const
+{
+	return numberOfTanks;
+}
+
+int TankStore::GetColumn(double x) const
+{
+	int column = (int)floor(x / TankGridCellSize);
+	return min(max(column, 0), numberOfColumns - 1);
+}
+
+int TankStore::GetRow(double y) const
+{
+	int row = (int)floor(y / TankGridCellSize);
+	return min(max(row, 0), numberOfRows - 1);
+}
+
+int TankStore::GetCell(int index) const
+{
+	return GetRow(y[index]) * numberOfColumns + GetColumn(x[index]);
+}
+
+float TankStore::GetDistanceFromCell(int index, int cell) const
+{
+	//The edge cells reach out past the world
+	int column = cell % numberOfColumns;
+	int row = cell / numberOfColumns;
+	float left = column == 0 ? -FLT_MAX : (float)column * TankGridCellSize;
+	float right = column == numberOfColumns - 1 ? FLT_MAX : (float)(column + 1) * TankGridCellSize;
+	float bottom = row == 0 ? -FLT_MAX : (float)row * TankGridCellSize;
+	float top = row == numberOfRows - 1 ? FLT_MAX : (float)(row + 1) * TankGridCellSize;
+
+	float distanceX = max(max(left - x[index], x[index] - right), 0.f);
+	float distanceY = max(max(bottom - y[index], y[index] - top), 0.f);
+	return max(distanceX, distanceY);
+}
+
+void TankStore::RebuildGrid()
+{
+	//Count the living tanks in each cell, then lay the cells out one after another and fill them
+	fill(cellCount.begin(), cellCount.end(), 0);
+	maxReach = 0;
+	maxDrift = 0;
+	firstOccupiedRow = numberOfRows;
+	lastOccupiedRow = -1;
+	for (int i = 0; i < numberOfTanks; i++)
+	{
+		if (aliveMask[i] != 0)
+		{
+			cellCount[GetCell(i)]++;
+			maxReach = max(maxReach, radius[i] + ReachMargin);
+			firstOccupiedRow = min(firstOccupiedRow, GetRow(y[i]));
+			lastOccupiedRow = max(lastOccupiedRow, GetRow(y[i]));
+		}
+	}
+
+	int total = 0;
+	for (size_t cell = 0; cell < cellCount.size(); cell++)
+	{
+		cellStart[cell] = total;
+		total += cellCount[cell];
+		cellCount[cell] = 0;
+	}
+	cellTanks.resize(total);
+	cellTankX.resize(total);
+	cellTankY.resize(total);
+	cellTankRadius.resize(total);
+	cellAliveMask.assign(total, -1);
+
+	for (int i = 0; i < numberOfTanks; i++)
+	{
+		if (aliveMask[i] != 0)
+		{
+			int cell = GetCell(i);
+			int slot = cellStart[cell] + cellCount[cell]++;
+			cellTanks[slot] = i;
+			cellTankX[slot] = x[i];
+			cellTankY[slot] = y[i];
+			cellTankRadius[slot] = radius[i];
+			tankCells[i] = cell;
+			tankSlots[i] = slot;
+		}
+	}
+	isGridStale = false;
+}
+
+//Writes the positions, among the count tanks in the arrays, of the living ones the trajectory passes close to
+//between time 0 and maxTime, in increasing order, and returns how many there are
+static int FilterTanksInReach(const Trajectory& trajectory, double maxTime, const float* x, const float* y, const float* radius, const int32_t* aliveMask, int count, int* indices)
+{
+	//Same test as the start of SolveCircleHitTime, in float: when the shell is within reach of the
+	//tank horizontally, and whether it is ever within reach vertically during that time
+	float startX = (float)trajectory.startX;
+	float startY = (float)trajectory.startY;
+	float velocityY = (float)trajectory.velocityY;
+	float halfGravity = (float)(0.5 * trajectory.gravity);
+	float endTime = (float)maxTime;
+	float apexTime = trajectory.gravity > 0 ? (float)(trajectory.velocityY / trajectory.gravity) : -1.f;
+
+	//A shell falling straight down is over a tank the whole time or never, and the huge inverse gives exactly that
+	float inverseVelocityX = trajectory.velocityX != 0 ? (float)(1 / trajectory.velocityX) : FLT_MAX;
+
+	int numberInReach = 0;
+	int i = 0;
+
+#if defined (TANKSTORE_USE_AVX2)
+	const __m256 startXs = _mm256_set1_ps(startX);
+	const __m256 startYs = _mm256_set1_ps(startY);
+	const __m256 velocityYs = _mm256_set1_ps(velocityY);
+	const __m256 halfGravities = _mm256_set1_ps(halfGravity);
+	const __m256 inverseVelocityXs = _mm256_set1_ps(inverseVelocityX);
+	const __m256 zeros = _mm256_setzero_ps();
+	const __m256 endTimes = _mm256_set1_ps(endTime);
+	const __m256 apexTimes = _mm256_set1_ps(apexTime);
+	const __m256 margins = _mm256_set1_ps(ReachMargin);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 centerX = _mm256_loadu_ps(&x[i]);
+		__m256 centerY = _mm256_loadu_ps(&y[i]);
+		__m256 reach = _mm256_add_ps(_mm256_loadu_ps(&radius[i]), margins);
+
+		__m256 time1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(centerX, reach), startXs), inverseVelocityXs);
+		__m256 time2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(centerX, reach), startXs), inverseVelocityXs);
+		__m256 windowStart = _mm256_max_ps(zeros, _mm256_min_ps(time1, time2));
+		__m256 windowEnd = _mm256_min_ps(endTimes, _mm256_max_ps(time1, time2));
+
+		//y(t) = startY + t * (velocityY - halfGravity * t)
+		__m256 startHeight = _mm256_add_ps(startYs, _mm256_mul_ps(windowStart, _mm256_sub_ps(velocityYs, _mm256_mul_ps(halfGravities, windowStart))));
+		__m256 endHeight = _mm256_add_ps(startYs, _mm256_mul_ps(windowEnd, _mm256_sub_ps(velocityYs, _mm256_mul_ps(halfGravities, windowEnd))));
+		__m256 apexInWindow = _mm256_and_ps(_mm256_cmp_ps(apexTimes, windowStart, _CMP_GT_OQ), _mm256_cmp_ps(apexTimes, windowEnd, _CMP_LT_OQ));
+		__m256 apexHeight = _mm256_add_ps(startYs, _mm256_mul_ps(apexTimes, _mm256_sub_ps(velocityYs, _mm256_mul_ps(halfGravities, apexTimes))));
+		__m256 highest = _mm256_blendv_ps(_mm256_max_ps(startHeight, endHeight), apexHeight, apexInWindow);
+		__m256 lowest = _mm256_min_ps(startHeight, endHeight);
+
+		__m256 inReach = _mm256_cmp_ps(windowStart, windowEnd, _CMP_LE_OQ);
+		inReach = _mm256_and_ps(inReach, _mm256_cmp_ps(highest, _mm256_sub_ps(centerY, reach), _CMP_GE_OQ));
+		inReach = _mm256_and_ps(inReach, _mm256_cmp_ps(lowest, _mm256_add_ps(centerY, reach), _CMP_LE_OQ));
+		inReach = _mm256_and_ps(inReach, _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)&aliveMask[i])));
+
+		int laneMask = _mm256_movemask_ps(inReach);
+		for (int lane = 0; laneMask != 0; lane++, laneMask >>= 1)
+		{
+			if (laneMask & 1)
+			{
+				indices[numberInReach++] = i + lane;
+			}
+		}
+	}
+#elif defined (TANKSTORE_USE_SSE2)
+	const __m128 startXs = _mm_set1_ps(startX);
+	const __m128 startYs = _mm_set1_ps(startY);
+	const __m128 velocityYs = _mm_set1_ps(velocityY);
+	const __m128 halfGravities = _mm_set1_ps(halfGravity);
+	const __m128 inverseVelocityXs = _mm_set1_ps(inverseVelocityX);
+	const __m128 zeros = _mm_setzero_ps();
+	const __m128 endTimes = _mm_set1_ps(endTime);
+	const __m128 apexTimes = _mm_set1_ps(apexTime);
+	const __m128 margins = _mm_set1_ps(ReachMargin);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 centerX = _mm_loadu_ps(&x[i]);
+		__m128 centerY = _mm_loadu_ps(&y[i]);
+		__m128 reach = _mm_add_ps(_mm_loadu_ps(&radius[i]), margins);
+
+		__m128 time1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(centerX, reach), startXs), inverseVelocityXs);
+		__m128 time2 = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(centerX, reach), startXs), inverseVelocityXs);
+		__m128 windowStart = _mm_max_ps(zeros, _mm_min_ps(time1, time2));
+		__m128 windowEnd = _mm_min_ps(endTimes, _mm_max_ps(time1, time2));
+
+		__m128 startHeight = _mm_add_ps(startYs, _mm_mul_ps(windowStart, _mm_sub_ps(velocityYs, _mm_mul_ps(halfGravities, windowStart))));
+		__m128 endHeight = _mm_add_ps(startYs, _mm_mul_ps(windowEnd, _mm_sub_ps(velocityYs, _mm_mul_ps(halfGravities, windowEnd))));
+		__m128 apexInWindow = _mm_and_ps(_mm_cmpgt_ps(apexTimes, windowStart), _mm_cmplt_ps(apexTimes, windowEnd));
+		__m128 apexHeight = _mm_add_ps(startYs, _mm_mul_ps(apexTimes, _mm_sub_ps(velocityYs, _mm_mul_ps(halfGravities, apexTimes))));
+		__m128 edgeHighest = _mm_max_ps(startHeight, endHeight);
+		__m128 highest = _mm_or_ps(_mm_and_ps(apexInWindow, apexHeight), _mm_andnot_ps(apexInWindow, edgeHighest));
+		__m128 lowest = _mm_min_ps(startHeight, endHeight);
+
+		__m128 inReach = _mm_cmple_ps(windowStart, windowEnd);
+		inReach = _mm_and_ps(inReach, _mm_cmpge_ps(highest, _mm_sub_ps(centerY, reach)));
+		inReach = _mm_and_ps(inReach, _mm_cmple_ps(lowest, _mm_add_ps(centerY, reach)));
+		inReach = _mm_and_ps(inReach, _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&aliveMask[i])));
+
+		int laneMask = _mm_movemask_ps(inReach);
+		for (int lane = 0; laneMask != 0; lane++, laneMask >>= 1)
+		{
+			if (laneMask & 1)
+			{
+				indices[numberInReach++] = i + lane;
+			}
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		float reach = radius[i] + ReachMargin;
+		float time1 = (x[i] - reach - startX) * inverseVelocityX;
+		float time2 = (x[i] + reach - startX) * inverseVelocityX;
+		float windowStart = max(0.f, min(time1, time2));
+		float windowEnd = min(endTime, max(time1, time2));
+
+		float startHeight = startY + windowStart * (velocityY - halfGravity * windowStart);
+		float endHeight = startY + windowEnd * (velocityY - halfGravity * windowEnd);
+		float highest = max(startHeight, endHeight);
+		if (apexTime > windowStart && apexTime < windowEnd)
+		{
+			highest = startY + apexTime * (velocityY - halfGravity * apexTime);
+		}
+		float lowest = min(startHeight, endHeight);
+
+		if (aliveMask[i] != 0 && windowStart <= windowEnd && highest >= y[i] - reach && lowest <= y[i] + reach)
+		{
+			indices[numberInReach++] = i;
+		}
+	}
+	return numberInReach;
+}
+
+//Writes the positions, among the count tanks in the arrays, of the living ones whose circle comes within
+//blastRadius of the center, in increasing order, and returns how many there are
+static int FilterTanksInRadius(double centerX, double centerY, double blastRadius, const float* x, const float* y, const float* radius, const int32_t* aliveMask, int count, int* indices)
+{
+	float blastX = (float)centerX;
+	float blastY = (float)centerY;
+	float blastReach = (float)blastRadius + ReachMargin;
+
+	int numberInRadius = 0;
+	int i = 0;
+
+#if defined (TANKSTORE_USE_AVX2)
+	const __m256 blastXs = _mm256_set1_ps(blastX);
+	const __m256 blastYs = _mm256_set1_ps(blastY);
+	const __m256 blastReaches = _mm256_set1_ps(blastReach);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 offsetX = _mm256_sub_ps(_mm256_loadu_ps(&x[i]), blastXs);
+		__m256 offsetY = _mm256_sub_ps(_mm256_loadu_ps(&y[i]), blastYs);
+		__m256 reach = _mm256_add_ps(_mm256_loadu_ps(&radius[i]), blastReaches);
+		__m256 distanceSquared = _mm256_add_ps(_mm256_mul_ps(offsetX, offsetX), _mm256_mul_ps(offsetY, offsetY));
+
+		__m256 inRadius = _mm256_cmp_ps(distanceSquared, _mm256_mul_ps(reach, reach), _CMP_LE_OQ);
+		inRadius = _mm256_and_ps(inRadius, _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)&aliveMask[i])));
+
+		int laneMask = _mm256_movemask_ps(inRadius);
+		for (int lane = 0; laneMask != 0; lane++, laneMask >>= 1)
+		{
+			if (laneMask & 1)
+			{
+				indices[numberInRadius++] = i + lane;
+			}
+		}
+	}
+#elif defined (TANKSTORE_USE_SSE2)
+	const __m128 blastXs = _mm_set1_ps(blastX);
+	const __m128 blastYs = _mm_set1_ps(blastY);
+	const __m128 blastReaches = _mm_set1_ps(blastReach);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 offsetX = _mm_sub_ps(_mm_loadu_ps(&x[i]), blastXs);
+		__m128 offsetY = _mm_sub_ps(_mm_loadu_ps(&y[i]), blastYs);
+		__m128 reach = _mm_add_ps(_mm_loadu_ps(&radius[i]), blastReaches);
+		__m128 distanceSquared = _mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_mul_ps(offsetY, offsetY));
+
+		__m128 inRadius = _mm_cmple_ps(distanceSquared, _mm_mul_ps(reach, reach));
+		inRadius = _mm_and_ps(inRadius, _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&aliveMask[i])));
+
+		int laneMask = _mm_movemask_ps(inRadius);
+		for (int lane = 0; laneMask != 0; lane++, laneMask >>= 1)
+		{
+			if (laneMask & 1)
+			{
+				indices[numberInRadius++] = i + lane;
+			}
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		float offsetX = x[i] - blastX;
+		float offsetY = y[i] - blastY;
+		float reach = radius[i] + blastReach;
+		if (aliveMask[i] != 0 && offsetX * offsetX + offsetY * offsetY <= reach * reach)
+		{
+			indices[numberInRadius++] = i;
+		}
+	}
+	return numberInRadius;
+}
+
+int TankStore::FindTanksInReach(const Trajectory& trajectory, double maxTime, int* indices)
+{
+	if (numberAlive < TankGridMinimumTanks)
+	{
+		return FilterTanksInReach(trajectory, maxTime, x.data(), y.data(), radius.data(), aliveMask.data(), (int)x.size(), indices);
+	}
+
+	if (isGridStale)
+	{
+		RebuildGrid();
+	}
+
+	//Walk the columns the shell passes within reach of. x moves one way only, so each column is one
+	//window of time, and the rows it passes near in that window lie around the lowest and highest point in it.
+	//Each cell is looked at once, so no tank is found twice. Moved tanks may be up to maxDrift outside their cell
+	double reach = maxReach + maxDrift;
+	double endX = trajectory.startX + trajectory.velocityX * maxTime;
+	int firstColumn = GetColumn(min(trajectory.startX, endX) - reach);
+	int lastColumn = GetColumn(max(trajectory.startX, endX) + reach);
+	double apexTime = trajectory.gravity > 0 ? trajectory.velocityY / trajectory.gravity : -1;
+
+	int numberInReach = 0;
+	for (int column = firstColumn; column <= lastColumn; column++)
+	{
+		double windowStart = 0;
+		double windowEnd = maxTime;
+		if (trajectory.velocityX != 0)
+		{
+			//The edge columns reach out past the world
+			double left = column == 0 ? -HUGE_VAL : (double)column * TankGridCellSize - reach;
+			double right = column == numberOfColumns - 1 ? HUGE_VAL : (double)(column + 1) * TankGridCellSize + reach;
+			double time1 = (left - trajectory.startX) / trajectory.velocityX;
+			double time2 = (right - trajectory.startX) / trajectory.velocityX;
+			windowStart = max(windowStart, min(time1, time2));
+			windowEnd = min(windowEnd, max(time1, time2));
+			if (windowStart > windowEnd)
+			{
+				continue;
+			}
+		}
+
+		double positionX, startHeight, endHeight;
+		GetTrajectoryPosition(trajectory, windowStart, positionX, startHeight);
+		GetTrajectoryPosition(trajectory, windowEnd, positionX, endHeight);
+		double highest = max(startHeight, endHeight);
+		if (apexTime > windowStart && apexTime < windowEnd)
+		{
+			GetTrajectoryPosition(trajectory, apexTime, positionX, highest);
+		}
+
+		//Tanks usually sit in a band of a few rows, and the rest need not be looked at
+		int lastRow = min(GetRow(highest + reach), lastOccupiedRow);
+		for (int row = max(GetRow(min(startHeight, endHeight) - reach), firstOccupiedRow); row <= lastRow; row++)
+		{
+			//An empty cell past the last tank starts one past the end of the arrays, so it must not be indexed
+			int cell = row * numberOfColumns + column;
+			if (cellCount[cell] == 0)
+			{
+				continue;
+			}
+			int start = cellStart[cell];
+			int numberFound = FilterTanksInReach(trajectory, maxTime, &cellTankX[start], &cellTankY[start], &cellTankRadius[start], &cellAliveMask[start], cellCount[cell], found.data());
+			MarkFound(start, numberFound);
+			numberInReach += numberFound;
+		}
+	}
+
+	RestoreIndexOrder(numberInReach, indices);
+	return numberInReach;
+}
+
+int TankStore::FindTanksInRadius(double centerX, double centerY, double blastRadius, int* indices)
+{
+	if (numberAlive < TankGridMinimumTanks)
+	{
+		return FilterTanksInRadius(centerX, centerY, blastRadius, x.data(), y.data(), radius.data(), aliveMask.data(), (int)x.size(), indices);
+	}
+
+	if (isGridStale)
+	{
+		RebuildGrid();
+	}
+
+	//Every cell overlapping the square around the circle, widened by how far a tank can reach out of its cell
+	double reach = blastRadius + maxReach + maxDrift;
+	int firstColumn = GetColumn(centerX - reach);
+	int lastColumn = GetColumn(centerX + reach);
+	int firstRow = max(GetRow(centerY - reach), firstOccupiedRow);
+	int lastRow = min(GetRow(centerY + reach), lastOccupiedRow);
+
+	int numberInRadius = 0;
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		for (int column = firstColumn; column <= lastColumn; column++)
+		{
+			int cell = row * numberOfColumns + column;
+			if (cellCount[cell] == 0)
+			{
+				continue;
+			}
+			int start = cellStart[cell];
+			int numberFound = FilterTanksInRadius(centerX, centerY, blastRadius, &cellTankX[start], &cellTankY[start], &cellTankRadius[start], &cellAliveMask[start], cellCount[cell], found.data());
+			MarkFound(start, numberFound);
+			numberInRadius += numberFound;
+		}
+	}
+
+	RestoreIndexOrder(numberInRadius, indices);
+	return numberInRadius;
+}
+
+void TankStore::MarkFound(int start, int numberFound)
+{
+	for (int j = 0; j < numberFound; j++)
+	{
+		int i = cellTanks[start + found[j]];
+		foundBits[i / 64] |= 1ull << (i % 64);
+	}
+}
+
+void TankStore::RestoreIndexOrder(int numberFound, int* indices)
+{
+	int numberWritten = 0;
+	for (int word = 0; numberWritten < numberFound; word++)
+	{
+		uint64_t bits = foundBits[word];
+		foundBits[word] = 0;
+		while (bits != 0)
+		{
+			indices[numberWritten++] = word * 64 + CountTrailingZeros(bits);
+			bits &= bits - 1;
+		}
+	}
+}
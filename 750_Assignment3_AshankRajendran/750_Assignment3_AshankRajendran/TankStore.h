@@ -0,0 +1,100 @@
+#pragma once
+#include "Ballistics.h"
+#include <cstdint>
+#include <vector>
+
+//Number of tanks the collision tests look at per instruction: 8 with AVX2, 4 with SSE2. Define
+//TANKSTORE_DISABLE_SIMD to use the plain loop, which gives the same results
+#if !defined (TANKSTORE_DISABLE_SIMD) && defined (__AVX2__)
+#define TANKSTORE_USE_AVX2 1
+const int TankStoreLanes = 8;
+#elif !defined (TANKSTORE_DISABLE_SIMD) && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TANKSTORE_USE_SSE2 1
+const int TankStoreLanes = 4;
+#else
+const int TankStoreLanes = 1;
+#endif
+
+//Side of the square cells of the tank grid, in pixels
+const int TankGridCellSize = 32;
+
+//With fewer living tanks than this, one SIMD pass over all of them is quicker than walking the grid
+const int TankGridMinimumTanks = 256;
+
+//Positions and sizes of a match's tanks as a structure of arrays, so the collision tests can check a
+//whole SIMD register of tanks at once instead of one Tank at a time. The arrays are padded with dead
+//tanks up to a multiple of TankStoreLanes.
+//The tanks are also binned into a uniform grid over the world, so with many tanks a query only tests
+//the tanks in the cells a trajectory passes near instead of looking at every tank. Tanks beyond the
+//edge of the world go in the edge cells
+class TankStore
+{
+public:
+	//Makes room for numberOfTanks tanks in a worldWidth by worldHeight world, all dead until SetTank is called
+	void Reset(int numberOfTanks, int worldWidth, int worldHeight);
+
+	//Moving or reviving a tank rebuilds the grid on the next query. A tank dying only takes it out of its cell
+	void SetTank(int index, float x, float y, float radius);
+	void SetAlive(int index, bool isAlive);
+
+	//Moves a tank without changing its size. The tank stays filed under its old cell and queries look
+	//that much further out, until some tank has moved more than a cell away and the grid is rebuilt
+	void MoveTank(int index, float x, float y);
+
+	int GetNumberOfTanks() const;
+
+	//Writes the indices of the living tanks the trajectory passes close to between time 0 and maxTime
+	//to indices, in increasing order, and returns how many there are. Every tank the shell can hit in
+	//that time is among them, so only those need the exact test. indices needs room for every tank
+	int FindTanksInReach(const Trajectory& trajectory, double maxTime, int* indices);
+
+	//Writes the indices of the living tanks whose circle comes within about blastRadius of the center to
+	//indices, in increasing order, and returns how many there are. Every tank the circle overlaps is among
+	//them, with at most a pixel to spare, so only those need the exact test. indices needs room for every tank
+	int FindTanksInRadius(double centerX, double centerY, double blastRadius, int* indices);
+
+private:
+	void RebuildGrid();
+	int GetCell(int index) const;
+	float GetDistanceFromCell(int index, int cell) const;
+	int GetColumn(double x) const;
+	int GetRow(double y) const;
+
+	//The cells are not walked in index order, so the tanks the filters find in each are marked in a bitmap,
+	//which is then read back a word at a time to write them out in increasing order
+	void MarkFound(int start, int numberFound);
+	void RestoreIndexOrder(int numberFound, int* indices);
+
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> radius;
+	std::vector<int32_t> aliveMask; //All bits set for a living tank, so it can be used as a lane mask
+
+	int numberOfTanks = 0;
+	int numberAlive = 0;
+
+	//Tanks in each cell, row by row: cell c holds cellTanks[cellStart[c]] onwards, cellCount[c] of them,
+	//with copies of their details alongside so the filters can read a cell straight through.
+	//A tank is only in the cell its center was in at the last rebuild, so queries look maxReach + maxDrift
+	//further out than the trajectory
+	int numberOfColumns = 0;
+	int numberOfRows = 0;
+	float maxReach = 0;
+	float maxDrift = 0; //Furthest any living tank is from the cell it is filed under
+	int firstOccupiedRow = 0;
+	int lastOccupiedRow = -1;
+	std::vector<int> cellStart;
+	std::vector<int> cellCount;
+	std::vector<int> cellTanks;
+	std::vector<float> cellTankX;
+	std::vector<float> cellTankY;
+	std::vector<float> cellTankRadius;
+	std::vector<int32_t> cellAliveMask; //All set; the tanks in the cells are the living ones
+	std::vector<int> tankCells; //Cell each living tank is filed under
+	std::vector<int> tankSlots; //Where in cellTanks each living tank is
+	bool isGridStale = true;
+
+	//Scratch space for the queries: the positions the filters find in a cell, and one bit per tank, all clear between queries
+	std::vector<int> found;
+	std::vector<uint64_t> foundBits;
+};
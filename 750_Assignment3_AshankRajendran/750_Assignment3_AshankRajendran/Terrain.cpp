@@ -0,0 +1,299 @@
+#include "Terrain.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined (TERRAIN_USE_AVX2)
+#include <immintrin.h>
+#elif defined (TERRAIN_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+static float SnapToHeightGrid(double height)
+{
+	return (float)(floor(height * TerrainHeightSteps + 0.5) / TerrainHeightSteps);
+}
+
+void Terrain::Reset(int width, float height)
+{
+	heights.assign(width, SnapToHeightGrid(height));
+	blockHeights.assign((width + TerrainBlockSize - 1) / TerrainBlockSize, 0.f);
+	if (width > 0)
+	{
+		UpdateBlockHeights(0, width - 1);
+	}
+
+	generation++;
+	carveCount = 0;
+}
+
+int Terrain::GetWidth() const
+{
+	return (int)heights.size();
+}
+
+int Terrain::GetColumn(double x) const
+{
+	if (!(x >= 0))
+	{
+		return 0;
+	}
+	return x < GetWidth() ? (int)x : GetWidth() - 1;
+}
+
+float Terrain::GetHeight(double x) const
+{
+	return heights[GetColumn(x)];
+}
+
+const float* Terrain::GetHeights() const
+{
+	return heights.data();
+}
+
+void Terrain::UpdateBlockHeights(int firstColumn, int lastColumn)
+{
+	for (int block = firstColumn / TerrainBlockSize; block <= lastColumn / TerrainBlockSize; block++)
+	{
+		auto blockStart = heights.begin() + block * TerrainBlockSize;
+		auto blockEnd = heights.begin() + min((block + 1) * TerrainBlockSize, GetWidth());
+		blockHeights[block] = *max_element(blockStart, blockEnd);
+	}
+}
+
+void Terrain::BuildCraterProfile(int radius)
+{
+	//Whole steps of the height grid, worked out with integers so the profile is the same everywhere
+	craterProfile.resize(2 * radius + 1);
+	for (int offset = -radius; offset <= radius; offset++)
+	{
+		int64_t square = (int64_t)(radius * radius - offset * offset) * TerrainHeightSteps * TerrainHeightSteps;
+		craterProfile[offset + radius] = (float)IntegerSquareRoot(square) / TerrainHeightSteps;
+	}
+	craterRadius = radius;
+}
+
+//Cuts a circle centered at height centerY out of count columns, halfHeights giving how far it reaches above
+//and below its center in each, and drops the ground above the circle into the gap. Every value involved is
+//on the height grid and far inside float precision, so each operation is exact and the lanes match the plain loop
+static void CarveColumns(float* heights, const float* halfHeights, int count, float centerY)
+{
+	int i = 0;
+
+#if defined (TERRAIN_USE_AVX2)
+	const __m256 centers = _mm256_set1_ps(centerY);
+	const __m256 zeros = _mm256_setzero_ps();
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 height = _mm256_loadu_ps(&heights[i]);
+		__m256 halfHeight = _mm256_loadu_ps(&halfHeights[i]);
+		__m256 aboveBottom = _mm256_max_ps(_mm256_sub_ps(height, _mm256_sub_ps(centers, halfHeight)), zeros);
+		__m256 removed = _mm256_min_ps(aboveBottom, _mm256_add_ps(halfHeight, halfHeight));
+		_mm256_storeu_ps(&heights[i], _mm256_max_ps(_mm256_sub_ps(height, removed), zeros));
+	}
+#elif defined (TERRAIN_USE_SSE2)
+	const __m128 centers = _mm_set1_ps(centerY);
+	const __m128 zeros = _mm_setzero_ps();
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 height = _mm_loadu_ps(&heights[i]);
+		__m128 halfHeight = _mm_loadu_ps(&halfHeights[i]);
+		__m128 aboveBottom = _mm_max_ps(_mm_sub_ps(height, _mm_sub_ps(centers, halfHeight)), zeros);
+		__m128 removed = _mm_min_ps(aboveBottom, _mm_add_ps(halfHeight, halfHeight));
+		_mm_storeu_ps(&heights[i], _mm_max_ps(_mm_sub_ps(height, removed), zeros));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		float aboveBottom = max(heights[i] - (centerY - halfHeights[i]), 0.f);
+		float removed = min(aboveBottom, halfHeights[i] + halfHeights[i]);
+		heights[i] = max(heights[i] - removed, 0.f);
+	}
+}
+
+bool Terrain::Carve(double centerX, double centerY, int radius, int& firstColumn, int& lastColumn)
+{
+	if (radius < 0 || !(centerX >= -radius && centerX < GetWidth() + radius))
+	{
+		return false;
+	}
+
+	int centerColumn = (int)floor(centerX);
+	firstColumn = max(centerColumn - radius, 0);
+	lastColumn = min(centerColumn + radius, GetWidth() - 1);
+	if (firstColumn > lastColumn)
+	{
+		return false;
+	}
+
+	if (radius != craterRadius)
+	{
+		BuildCraterProfile(radius);
+	}
+
+	int profileStart = firstColumn - (centerColumn - radius);
+	CarveColumns(&heights[firstColumn], &craterProfile[profileStart], lastColumn - firstColumn + 1, SnapToHeightGrid(centerY));
+	UpdateBlockHeights(firstColumn, lastColumn);
+
+	carvedFirstColumns[carveCount % TerrainCarveHistory] = firstColumn;
+	carvedLastColumns[carveCount % TerrainCarveHistory] = lastColumn;
+	carveCount++;
+	return true;
+}
+
+static double GetHeightAt(const Trajectory& trajectory, double time)
+{
+	double x, y;
+	GetTrajectoryPosition(trajectory, time, x, y);
+	return y;
+}
+
+double Terrain::SolveExitTime(const Trajectory& trajectory) const
+{
+	int width = GetWidth();
+	if (!(trajectory.startX >= 0 && trajectory.startX <= width))
+	{
+		return 0;
+	}
+
+	int column = GetColumn(trajectory.startX);
+	double enterTime = 0;
+	double enterHeight = GetHeightAt(trajectory, 0);
+
+	//Straight up and down, the shell stays over the one column
+	if (trajectory.velocityX == 0)
+	{
+		return enterHeight < heights[column] ? 0 : ::SolveExitTime(trajectory, heights[column], width);
+	}
+
+	int step = trajectory.velocityX > 0 ? 1 : -1;
+	int worldEdge = step > 0 ? width : 0;
+	double edgeTime = (worldEdge - trajectory.startX) / trajectory.velocityX;
+
+	while (true)
+	{
+		//The flight is a downward parabola, so if the shell is above a block's highest column where it comes in
+		//and where it goes out, it is above the whole block
+		int block = column / TerrainBlockSize;
+		int blockFirst = block * TerrainBlockSize;
+		int blockLast = min(blockFirst + TerrainBlockSize, width) - 1;
+		int blockEdge = step > 0 ? blockLast + 1 : blockFirst;
+		double leaveTime = (blockEdge - trajectory.startX) / trajectory.velocityX;
+		double leaveHeight = GetHeightAt(trajectory, leaveTime);
+
+		if (enterHeight >= blockHeights[block] && leaveHeight >= blockHeights[block])
+		{
+			if (blockEdge == worldEdge)
+			{
+				return edgeTime;
+			}
+			column = blockEdge - (step > 0 ? 0 : 1);
+			enterTime = leaveTime;
+			enterHeight = leaveHeight;
+			continue;
+		}
+
+		//Otherwise the same test one column at a time
+		for (; column >= blockFirst && column <= blockLast; column += step)
+		{
+			double columnLeaveTime = (column + (step > 0 ? 1 : 0) - trajectory.startX) / trajectory.velocityX;
+			double columnLeaveHeight = GetHeightAt(trajectory, columnLeaveTime);
+			float height = heights[column];
+
+			//Into the side of the column as it crosses over from the last one
+			if (enterHeight < height)
+			{
+				return enterTime;
+			}
+
+			//Down onto its top, at the later root as with flat ground
+			if (columnLeaveHeight < height)
+			{
+				return min(max(::SolveExitTime(trajectory, height, width), enterTime), columnLeaveTime);
+			}
+
+			enterTime = columnLeaveTime;
+			enterHeight = columnLeaveHeight;
+		}
+
+		if (column < 0 || column >= width)
+		{
+			return edgeTime;
+		}
+	}
+}
+
+long long Terrain::SolveFixedExitTick(const FixedTrajectory& trajectory, long long fromTick) const
+{
+	int width = GetWidth();
+	Fixed worldWidth = (Fixed)width << FixedFractionBits;
+
+	long long tick = fromTick + 1;
+	while (tick <= MaxFixedFlightTicks)
+	{
+		Fixed x, y;
+		GetFixedPosition(trajectory, tick, x, y);
+		if (x < 0 || x > worldWidth)
+		{
+			return tick;
+		}
+
+		//Skip the ticks over a block the shell stays above the highest column of, as in SolveExitTime
+		int block = min((int)(x >> FixedFractionBits), width - 1) / TerrainBlockSize;
+		int blockFirst = block * TerrainBlockSize;
+		int blockLast = min(blockFirst + TerrainBlockSize, width) - 1;
+		Fixed blockLowX = (Fixed)blockFirst << FixedFractionBits;
+		Fixed blockHighX = blockLast == width - 1 ? worldWidth : ((Fixed)(blockLast + 1) << FixedFractionBits) - 1;
+		long long blockEndTick = GetFixedLastTickBetween(trajectory, tick, blockLowX, blockHighX);
+
+		tick = SolveFixedTickBelow(trajectory, tick, blockEndTick, ToFixed(blockHeights[block]));
+		if (tick == -1)
+		{
+			tick = blockEndTick + 1;
+			continue;
+		}
+
+		//Nothing before that tick can be below any column in the block, so the columns are looked at from there
+		while (tick <= blockEndTick)
+		{
+			GetFixedPosition(trajectory, tick, x, y);
+			int column = min((int)(x >> FixedFractionBits), width - 1);
+			Fixed columnLowX = (Fixed)column << FixedFractionBits;
+			Fixed columnHighX = column == width - 1 ? worldWidth : ((Fixed)(column + 1) << FixedFractionBits) - 1;
+			long long columnEndTick = min(GetFixedLastTickBetween(trajectory, tick, columnLowX, columnHighX), blockEndTick);
+
+			long long hitTick = SolveFixedTickBelow(trajectory, tick, columnEndTick, ToFixed(heights[column]));
+			if (hitTick != -1)
+			{
+				return hitTick;
+			}
+			tick = columnEndTick + 1;
+		}
+	}
+	return MaxFixedFlightTicks;
+}
+
+unsigned int Terrain::GetGeneration() const
+{
+	return generation;
+}
+
+long long Terrain::GetCarveCount() const
+{
+	return carveCount;
+}
+
+bool Terrain::GetCarvedColumns(long long carveNumber, int& firstColumn, int& lastColumn) const
+{
+	if (carveNumber < 0 || carveNumber >= carveCount || carveCount - carveNumber > TerrainCarveHistory)
+	{
+		return false;
+	}
+	firstColumn = carvedFirstColumns[carveNumber % TerrainCarveHistory];
+	lastColumn = carvedLastColumns[carveNumber % TerrainCarveHistory];
+	return true;
+}
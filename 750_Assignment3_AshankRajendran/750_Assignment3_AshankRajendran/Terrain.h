@@ -0,0 +1,76 @@
+#pragma once
+#include "Ballistics.h"
+#include "FixedBallistics.h"
+#include <vector>
+
+//Number of columns the crater kernel carves per instruction: 8 with AVX2, 4 with SSE2. Define
+//TERRAIN_DISABLE_SIMD to use the plain loop, which gives the same results
+#if !defined (TERRAIN_DISABLE_SIMD) && defined (__AVX2__)
+#define TERRAIN_USE_AVX2 1
+#elif !defined (TERRAIN_DISABLE_SIMD) && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TERRAIN_USE_SSE2 1
+#endif
+
+//Heights are whole multiples of 1 / TerrainHeightSteps pixels
+const int TerrainHeightSteps = 256;
+
+//Columns per block of the highest-column summary the flight solvers use to skip over ground a shell is well above
+const int TerrainBlockSize = 32;
+
+//Carves remembered for GetCarvedColumns
+const int TerrainCarveHistory = 64;
+
+//Height of the ground in every one pixel wide column of the world. Shells blast craters out of it and the
+//ground above a crater falls in, so each column is always solid from y = 0 up to its height.
+//Heights stay on a 1 / TerrainHeightSteps grid, which floats hold exactly, so carving gives the same
+//heights on every machine, with or without SIMD
+class Terrain
+{
+public:
+	//Flat ground of the given height across width columns
+	void Reset(int width, float height);
+
+	int GetWidth() const;
+
+	//Height of the column x is in. Positions beyond the edges use the edge columns
+	float GetHeight(double x) const;
+	const float* GetHeights() const;
+
+	//Removes a circle of ground and drops what was above it into the hole. Returns false if the circle misses
+	//every column, otherwise the columns it reaches through firstColumn and lastColumn
+	bool Carve(double centerX, double centerY, int radius, int& firstColumn, int& lastColumn);
+
+	//Returns when, from the start of the trajectory, the shell first goes into the ground or crosses
+	//x = 0 or x = width, whichever comes first. 0 if it starts there
+	double SolveExitTime(const Trajectory& trajectory) const;
+
+	//Fixed point version. Returns the first tick after fromTick at which the shell is below the ground of
+	//the column it is over or past x = 0 or x = width, or MaxFixedFlightTicks if there is none
+	long long SolveFixedExitTick(const FixedTrajectory& trajectory, long long fromTick) const;
+
+	//Lets a renderer keep its own copy of the heights up to date one carve at a time, like the trail rings.
+	//Reset starts a new generation; the carves since then are numbered from 0
+	unsigned int GetGeneration() const;
+	long long GetCarveCount() const;
+
+	//Columns changed by carve number carveNumber. Returns false once it is too old to be remembered, and
+	//then every column should be treated as changed
+	bool GetCarvedColumns(long long carveNumber, int& firstColumn, int& lastColumn) const;
+
+private:
+	int GetColumn(double x) const;
+	void UpdateBlockHeights(int firstColumn, int lastColumn);
+	void BuildCraterProfile(int radius);
+
+	std::vector<float> heights;
+	std::vector<float> blockHeights; //Highest column in each run of TerrainBlockSize columns
+
+	//Half the height of a crater of craterRadius, for each column from -craterRadius to craterRadius off its center
+	std::vector<float> craterProfile;
+	int craterRadius = -1;
+
+	unsigned int generation = 0;
+	long long carveCount = 0;
+	int carvedFirstColumns[TerrainCarveHistory] = {};
+	int carvedLastColumns[TerrainCarveHistory] = {};
+};
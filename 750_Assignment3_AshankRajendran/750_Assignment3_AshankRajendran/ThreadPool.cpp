@@ -0,0 +1,143 @@
+#include "ThreadPool.h"
+
+//Index of the worker running on this thread, or -1 on threads that do not belong to a pool
+static thread_local int currentWorkerIndex = -1;
+static thread_local const ThreadPool* currentWorkerPool = nullptr;
+
+ThreadPool::ThreadPool(int numberOfThreads)
+{
+	if (numberOfThreads <= 0)
+	{
+		numberOfThreads = (int)std::thread::hardware_concurrency();
+		if (numberOfThreads <= 0)
+		{
+			numberOfThreads = 1;
+		}
+	}
+
+	for (int i = 0; i < numberOfThreads; i++)
+	{
+		queues.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	for (int i = 0; i < numberOfThreads; i++)
+	{
+		workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	WaitForAll();
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wakeCondition.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+	int queueIndex;
+	if (currentWorkerPool == this)
+	{
+		queueIndex = currentWorkerIndex;
+	}
+	else
+	{
+		queueIndex = nextQueueIndex++ % queues.size();
+	}
+
+	pendingTasks++;
+	{
+		std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+		queues[queueIndex]->tasks.push_back(std::move(task));
+	}
+
+	//Counted under the sleep mutex so a worker about to sleep cannot miss the wake up
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		queuedTasks++;
+	}
+	wakeCondition.notify_one();
+}
+
+void ThreadPool::WaitForAll()
+{
+	std::unique_lock<std::mutex> lock(sleepMutex);
+	idleCondition.wait(lock, [this] { return pendingTasks == 0; });
+}
+
+int ThreadPool::GetNumberOfThreads() const
+{
+	return (int)workers.size();
+}
+
+bool ThreadPool::PopOwnTask(int workerIndex, std::function<void()>& task)
+{
+	WorkerQueue& queue = *queues[workerIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.tasks.empty())
+	{
+		return false;
+	}
+
+	//Newest first, its data is most likely still in this core's cache
+	task = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	return true;
+}
+
+bool ThreadPool::StealTask(int thiefIndex, std::function<void()>& task)
+{
+	int numberOfQueues = (int)queues.size();
+	for (int offset = 1; offset < numberOfQueues; offset++)
+	{
+		WorkerQueue& victim = *queues[(thiefIndex + offset) % numberOfQueues];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty())
+		{
+			//Oldest first, it is the one the owner is least likely to want next
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::WorkerLoop(int workerIndex)
+{
+	currentWorkerIndex = workerIndex;
+	currentWorkerPool = this;
+
+	while (true)
+	{
+		std::function<void()> task;
+		if (PopOwnTask(workerIndex, task) || StealTask(workerIndex, task))
+		{
+			queuedTasks--;
+			task();
+
+			if (--pendingTasks == 0)
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+				idleCondition.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wakeCondition.wait(lock, [this] { return stopping || queuedTasks > 0; });
+		if (stopping && queuedTasks == 0)
+		{
+			return;
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Fixed set of worker threads with one task queue per worker. A worker takes its newest
+//task first, and once its own queue runs dry it steals the oldest task of another worker,
+//so uneven task lengths still keep every core busy
+class ThreadPool
+{
+public:
+	//0 threads means one per hardware thread
+	explicit ThreadPool(int numberOfThreads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//Queues a task. Tasks submitted from a worker go to that worker's own queue
+	void Submit(std::function<void()> task);
+
+	//Blocks until every submitted task has finished
+	void WaitForAll();
+
+	int GetNumberOfThreads() const;
+
+private:
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	void WorkerLoop(int workerIndex);
+	bool PopOwnTask(int workerIndex, std::function<void()>& task);
+	bool StealTask(int thiefIndex, std::function<void()>& task);
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<std::thread> workers;
+
+	//Tasks submitted but not yet finished, and tasks still waiting in a queue
+	std::atomic<int> pendingTasks{ 0 };
+	std::atomic<int> queuedTasks{ 0 };
+	std::atomic<unsigned int> nextQueueIndex{ 0 };
+	bool stopping = false;
+
+	std::mutex sleepMutex;
+	std::condition_variable wakeCondition;
+	std::condition_variable idleCondition;
+};
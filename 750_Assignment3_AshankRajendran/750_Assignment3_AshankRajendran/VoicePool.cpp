@@ -0,0 +1,86 @@
+#include "VoicePool.h"
+
+using namespace std;
+
+bool VoicePool::Create(int numberOfVoices)
+{
+	Destroy();
+
+	voices.resize(numberOfVoices);
+	for (int i = 0; i < numberOfVoices; i++)
+	{
+		alGenSources(1, &voices[i].source);
+		if (alGetError() != AL_NO_ERROR)
+		{
+			//Keep the sources that were made, OpenAL just has fewer to give
+			voices.resize(i);
+			return false;
+		}
+
+		ALuint source = voices[i].source;
+		alSource3f(source, AL_POSITION, 1.f, 0.f, 0.f);
+		alSource3f(source, AL_VELOCITY, 0.f, 0.f, 0.f);
+		alSourcef(source, AL_PITCH, 1.f);
+		alSourcef(source, AL_GAIN, 1.f);
+		alSourcei(source, AL_LOOPING, AL_FALSE);
+	}
+	return true;
+}
+
+void VoicePool::Destroy()
+{
+	for (Voice& voice : voices)
+	{
+		alSourceStop(voice.source);
+		alDeleteSources(1, &voice.source);
+	}
+	voices.clear();
+}
+
+bool VoicePool::Play(ALuint buffer, int priority, double durationSeconds, double currentTime)
+{
+	if (voices.empty())
+	{
+		return false;
+	}
+
+	//A finished voice is always taken first, otherwise the least important, oldest one
+	Voice* chosenVoice = nullptr;
+	for (Voice& voice : voices)
+	{
+		if (voice.endTime <= currentTime)
+		{
+			chosenVoice = &voice;
+			break;
+		}
+		if (chosenVoice == nullptr || voice.priority < chosenVoice->priority ||
+			(voice.priority == chosenVoice->priority && voice.startOrder < chosenVoice->startOrder))
+		{
+			chosenVoice = &voice;
+		}
+	}
+
+	if (chosenVoice->endTime > currentTime && chosenVoice->priority > priority)
+	{
+		return false;
+	}
+
+	//A source can only change buffers once it has stopped
+	if (chosenVoice->buffer != buffer)
+	{
+		alSourceStop(chosenVoice->source);
+		alSourcei(chosenVoice->source, AL_BUFFER, buffer);
+		chosenVoice->buffer = buffer;
+	}
+	alSourcePlay(chosenVoice->source);
+
+	chosenVoice->priority = priority;
+	chosenVoice->startOrder = ++playCount;
+	chosenVoice->endTime = currentTime + durationSeconds;
+	return true;
+}
+
+int VoicePool::GetNumberOfVoices() const
+{
+	return (int)voices.size();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <AL/al.h>
+#include <vector>
+
+//Fixed set of OpenAL sources shared by every sound effect, so overlapping effects each get their
+//own source instead of restarting one another. All sources are created up front; playing a sound
+//reuses a source that has finished, or steals the least important one, and never allocates
+class VoicePool
+{
+public:
+	//Creates numberOfVoices sources. Returns false if OpenAL could not create them all
+	bool Create(int numberOfVoices);
+	void Destroy();
+
+	//Plays buffer, which lasts durationSeconds, on a free voice. When every voice is busy the one
+	//with the lowest priority is stolen, the oldest if several tie, as long as its priority is not
+	//above the new sound's. Returns false if the sound was dropped instead. currentTime is in
+	//seconds on whatever clock the caller plays by, and only has to keep increasing
+	bool Play(ALuint buffer, int priority, double durationSeconds, double currentTime);
+
+	int GetNumberOfVoices() const;
+
+private:
+	struct Voice
+	{
+		ALuint source = 0;
+		ALuint buffer = 0;
+		int priority = 0;
+		unsigned long long startOrder = 0; //Higher is younger
+		double endTime = 0; //Time when the sound finishes
+	};
+
+	std::vector<Voice> voices;
+	unsigned long long playCount = 0;
+};
@@ -31,6 +31,9 @@
 #include <unordered_map>
 #include <iterator>
 #include <algorithm>
+#include <limits>
+#include <cstring>
+#include "AudioSampleConversion.h"
 
 // disable some warnings on Windows
 #if defined (_MSC_VER)
@@ -89,6 +92,14 @@ public:
 	 */
 	bool load(std::string filePath);
 
+	/** Loads a .WAV file without decoding its samples, keeping the interleaved bytes of the data
+	 * chunk exactly as they are stored in the file. The sample rate, bit depth and number of
+	 * channels are read as usual but the samples buffer is left empty, so use
+	 * getRawPCMNumSamplesPerChannel() rather than getNumSamplesPerChannel().
+	 * @Returns true if the file was successfully loaded
+	 */
+	bool loadRawPCM(std::string filePath);
+
 	/** Saves an audio file to a given file path.
 	 * @Returns true if the file was successfully saved
 	 */
@@ -119,6 +130,19 @@ public:
 	/** Prints a summary of the audio file to the console */
 	void printSummary() const;
 
+	//=============================================================
+	/** @Returns the interleaved sample bytes kept by loadRawPCM(), or nullptr if there are none */
+	const uint8_t* getRawPCMData() const;
+
+	/** @Returns the number of bytes returned by getRawPCMData() */
+	size_t getRawPCMSize() const;
+
+	/** @Returns the number of samples per channel kept by loadRawPCM() */
+	int getRawPCMNumSamplesPerChannel() const;
+
+	/** @Returns true if the samples kept by loadRawPCM() are 32 bit floats rather than integers */
+	bool isRawPCMFloat() const;
+
 	//=============================================================
 
 	/** Set the audio buffer for this AudioFile by copying samples from another buffer.
@@ -173,12 +197,26 @@ private:
 	};
 
 	//=============================================================
+	/** Where the samples of a .WAV file are and how they are stored */
+	struct WaveLayout
+	{
+		int16_t audioFormat;
+		int numChannels;
+		int numBytesPerBlock;
+		int numSamples;
+		int samplesStartIndex;
+	};
+
+	//=============================================================
+	bool readFile(const std::string& filePath, std::vector<uint8_t>& fileData);
 	AudioFileFormat determineAudioFileFormat(std::vector<uint8_t>& fileData);
+	bool decodeWaveHeader(std::vector<uint8_t>& fileData, WaveLayout& layout);
 	bool decodeWaveFile(std::vector<uint8_t>& fileData);
 	bool decodeAiffFile(std::vector<uint8_t>& fileData);
 
 	//=============================================================
 	bool saveToWaveFile(std::string filePath);
+	bool addSamplesToWaveData(std::vector<uint8_t>& fileData);
 	bool saveToAiffFile(std::string filePath);
 
 	//=============================================================
@@ -219,6 +257,10 @@ private:
 	uint32_t sampleRate;
 	int bitDepth;
 	bool logErrorsToConsole{ true };
+
+	//=============================================================
+	std::vector<uint8_t> rawPCMFileData;
+	WaveLayout rawPCMLayout{};
 };
 
 /** @note extracted this from writing to WAV file -- this is not part of the original library. */
@@ -226,56 +268,7 @@ template <class T>
 bool AudioFile<T>::writePCMToBuffer(std::vector<uint8_t>& fileData)
 {
 	fileData.clear();
-
-	int16_t audioFormat = bitDepth == 32 ? WavAudioFormat::IEEEFloat : WavAudioFormat::PCM;
-
-	for (int i = 0; i < getNumSamplesPerChannel(); i++)
-	{
-		for (int channel = 0; channel < getNumChannels(); channel++)
-		{
-			if (bitDepth == 8)
-			{
-				uint8_t byte = sampleToSingleByte(samples[channel][i]);
-				fileData.push_back(byte);
-			}
-			else if (bitDepth == 16)
-			{
-				int16_t sampleAsInt = sampleToSixteenBitInt(samples[channel][i]);
-				addInt16ToFileData(fileData, sampleAsInt);
-			}
-			else if (bitDepth == 24)
-			{
-				int32_t sampleAsIntAgain = (int32_t)(samples[channel][i] * (T)8388608.);
-
-				uint8_t bytes[3];
-				bytes[2] = (uint8_t)(sampleAsIntAgain >> 16) & 0xFF;
-				bytes[1] = (uint8_t)(sampleAsIntAgain >> 8) & 0xFF;
-				bytes[0] = (uint8_t)sampleAsIntAgain & 0xFF;
-
-				fileData.push_back(bytes[0]);
-				fileData.push_back(bytes[1]);
-				fileData.push_back(bytes[2]);
-			}
-			else if (bitDepth == 32)
-			{
-				int32_t sampleAsInt;
-
-				if (audioFormat == WavAudioFormat::IEEEFloat)
-					sampleAsInt = (int32_t) reinterpret_cast<int32_t&> (samples[channel][i]);
-				else // assume PCM
-					sampleAsInt = (int32_t)(samples[channel][i] * std::numeric_limits<int32_t>::max());
-
-				addInt32ToFileData(fileData, sampleAsInt, Endianness::LittleEndian);
-			}
-			else
-			{
-				assert(false && "Trying to write a file with unsupported bit depth");
-				return false;
-			}
-		}
-	}
-
-	return true;
+	return addSamplesToWaveData(fileData);
 }
 
 //=============================================================
@@ -494,18 +487,9 @@ void AudioFile<T>::shouldLogErrorsToConsole(bool logErrors)
 template <class T>
 bool AudioFile<T>::load(std::string filePath)
 {
-	std::ifstream file(filePath, std::ios::binary);
-
-	// check the file exists
-	if (!file.good())
-	{
-		reportError("ERROR: File doesn't exist or otherwise can't load file\n" + filePath);
+	std::vector<uint8_t> fileData;
+	if (!readFile(filePath, fileData))
 		return false;
-	}
-
-	file.unsetf(std::ios::skipws);
-	std::istream_iterator<uint8_t> begin(file), end;
-	std::vector<uint8_t> fileData(begin, end);
 
 	// get audio file format
 	audioFileFormat = determineAudioFileFormat(fileData);
@@ -527,7 +511,103 @@ bool AudioFile<T>::load(std::string filePath)
 
 //=============================================================
 template <class T>
-bool AudioFile<T>::decodeWaveFile(std::vector<uint8_t>& fileData)
+bool AudioFile<T>::loadRawPCM(std::string filePath)
+{
+	rawPCMFileData.clear();
+	rawPCMLayout = WaveLayout{};
+
+	std::vector<uint8_t> fileData;
+	if (!readFile(filePath, fileData))
+		return false;
+
+	audioFileFormat = determineAudioFileFormat(fileData);
+	if (audioFileFormat != AudioFileFormat::Wave)
+	{
+		reportError("ERROR: only .WAV files can be loaded as raw PCM");
+		return false;
+	}
+
+	WaveLayout layout;
+	if (!decodeWaveHeader(fileData, layout))
+		return false;
+
+	clearAudioBuffer();
+	samples.resize(layout.numChannels);
+
+	// keep the file itself rather than copying the data chunk out of it
+	rawPCMFileData = std::move(fileData);
+	rawPCMLayout = layout;
+	return true;
+}
+
+//=============================================================
+template <class T>
+const uint8_t* AudioFile<T>::getRawPCMData() const
+{
+	if (rawPCMFileData.empty())
+		return nullptr;
+
+	return rawPCMFileData.data() + rawPCMLayout.samplesStartIndex;
+}
+
+//=============================================================
+template <class T>
+size_t AudioFile<T>::getRawPCMSize() const
+{
+	return (size_t)rawPCMLayout.numSamples * rawPCMLayout.numBytesPerBlock;
+}
+
+//=============================================================
+template <class T>
+int AudioFile<T>::getRawPCMNumSamplesPerChannel() const
+{
+	return rawPCMLayout.numSamples;
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::isRawPCMFloat() const
+{
+	return rawPCMLayout.audioFormat == WavAudioFormat::IEEEFloat;
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::readFile(const std::string& filePath, std::vector<uint8_t>& fileData)
+{
+	std::ifstream file(filePath, std::ios::binary);
+
+	// check the file exists
+	if (!file.good())
+	{
+		reportError("ERROR: File doesn't exist or otherwise can't load file\n" + filePath);
+		return false;
+	}
+
+	// read the whole file in one go rather than a byte at a time
+	file.seekg(0, std::ios::end);
+	std::streamoff fileSize = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	if (fileSize < 12)
+	{
+		reportError("ERROR: File is too small to be an audio file\n" + filePath);
+		return false;
+	}
+
+	fileData.resize((size_t)fileSize);
+	if (!file.read((char*)fileData.data(), fileSize))
+	{
+		reportError("ERROR: Couldn't read file\n" + filePath);
+		return false;
+	}
+
+	return true;
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::decodeWaveHeader(std::vector<uint8_t>& fileData, WaveLayout& layout)
 {
 	// -----------------------------------------------------------
 	// HEADER CHUNK
@@ -539,7 +619,6 @@ bool AudioFile<T>::decodeWaveFile(std::vector<uint8_t>& fileData)
 	// try and find the start points of key chunks
 	int indexOfDataChunk = getIndexOfChunk(fileData, "data", 12);
 	int indexOfFormatChunk = getIndexOfChunk(fileData, "fmt ", 12);
-	int indexOfXMLChunk = getIndexOfChunk(fileData, "iXML", 12);
 
 	// if we can't find the data or format chunks, or the IDs/formats don't seem to be as expected
 	// then it is unlikely we'll able to read this file, so abort
@@ -597,61 +676,74 @@ bool AudioFile<T>::decodeWaveFile(std::vector<uint8_t>& fileData)
 	std::string dataChunkID(fileData.begin() + d, fileData.begin() + d + 4);
 	int32_t dataChunkSize = fourBytesToInt(fileData, d + 4);
 
-	int numSamples = dataChunkSize / (numChannels * bitDepth / 8);
 	int samplesStartIndex = indexOfDataChunk + 8;
 
-	clearAudioBuffer();
-	samples.resize(numChannels);
+	// don't trust a data chunk size that runs past the end of the file
+	int numBytesAvailable = (int)fileData.size() - samplesStartIndex;
+	if (dataChunkSize < 0 || dataChunkSize > numBytesAvailable)
+		dataChunkSize = std::max(numBytesAvailable, 0);
 
-	for (int i = 0; i < numSamples; i++)
-	{
-		for (int channel = 0; channel < numChannels; channel++)
-		{
-			int sampleIndex = samplesStartIndex + (numBytesPerBlock * i) + channel * numBytesPerSample;
+	layout.audioFormat = audioFormat;
+	layout.numChannels = numChannels;
+	layout.numBytesPerBlock = numBytesPerBlock;
+	layout.numSamples = dataChunkSize / numBytesPerBlock;
+	layout.samplesStartIndex = samplesStartIndex;
+	return true;
+}
 
-			if (bitDepth == 8)
-			{
-				T sample = singleByteToSample(fileData[sampleIndex]);
-				samples[channel].push_back(sample);
-			}
-			else if (bitDepth == 16)
-			{
-				int16_t sampleAsInt = twoBytesToInt(fileData, sampleIndex);
-				T sample = sixteenBitIntToSample(sampleAsInt);
-				samples[channel].push_back(sample);
-			}
-			else if (bitDepth == 24)
-			{
-				int32_t sampleAsInt = 0;
-				sampleAsInt = (fileData[sampleIndex + 2] << 16) | (fileData[sampleIndex + 1] << 8) | fileData[sampleIndex];
+//=============================================================
+template <class T>
+bool AudioFile<T>::decodeWaveFile(std::vector<uint8_t>& fileData)
+{
+	WaveLayout layout;
+	if (!decodeWaveHeader(fileData, layout))
+		return false;
 
-				if (sampleAsInt & 0x800000) //  if the 24th bit is set, this is a negative number in 24-bit world
-					sampleAsInt = sampleAsInt | ~0xFFFFFF; // so make sure sign is extended to the 32 bit float
+	int16_t audioFormat = layout.audioFormat;
+	int numChannels = layout.numChannels;
+	int numBytesPerBlock = layout.numBytesPerBlock;
+	int numSamples = layout.numSamples;
+	int samplesStartIndex = layout.samplesStartIndex;
 
-				T sample = (T)sampleAsInt / (T)8388608.;
-				samples[channel].push_back(sample);
-			}
-			else if (bitDepth == 32)
-			{
-				int32_t sampleAsInt = fourBytesToInt(fileData, sampleIndex);
-				T sample;
+	clearAudioBuffer();
+	samples.assign(numChannels, std::vector<T>(numSamples));
 
-				if (audioFormat == WavAudioFormat::IEEEFloat)
-					sample = (T)reinterpret_cast<float&> (sampleAsInt);
-				else // assume PCM
-					sample = (T)sampleAsInt / static_cast<float> (std::numeric_limits<std::int32_t>::max());
+	// convert a block of frames at a time into a small interleaved buffer, then split that into
+	// channels, so both passes stay in cache. Mono files are converted straight into place
+	const int numFramesPerBlock = 1024;
+	std::vector<T> interleavedSamples(numChannels > 1 ? (size_t)numFramesPerBlock * numChannels : 0);
+	std::vector<T*> channelSamples(numChannels);
 
-				samples[channel].push_back(sample);
-			}
-			else
-			{
-				assert(false);
-			}
+	for (int firstFrame = 0; firstFrame < numSamples; firstFrame += numFramesPerBlock)
+	{
+		int numFrames = std::min(numFramesPerBlock, numSamples - firstFrame);
+		size_t numValues = (size_t)numFrames * numChannels;
+		const uint8_t* source = fileData.data() + samplesStartIndex + (size_t)firstFrame * numBytesPerBlock;
+		T* destination = numChannels > 1 ? interleavedSamples.data() : samples[0].data() + firstFrame;
+
+		if (bitDepth == 8)
+			AudioSampleConversion::pcm8ToSamples(source, destination, numValues);
+		else if (bitDepth == 16)
+			AudioSampleConversion::pcm16ToSamples(source, destination, numValues);
+		else if (bitDepth == 24)
+			AudioSampleConversion::pcm24ToSamples(source, destination, numValues);
+		else if (audioFormat == WavAudioFormat::IEEEFloat)
+			AudioSampleConversion::float32ToSamples(source, destination, numValues);
+		else // 32 bit PCM
+			AudioSampleConversion::pcm32ToSamples(source, destination, numValues);
+
+		if (numChannels > 1)
+		{
+			for (int channel = 0; channel < numChannels; channel++)
+				channelSamples[channel] = samples[channel].data() + firstFrame;
+
+			AudioSampleConversion::deinterleave(destination, numChannels, (size_t)numFrames, channelSamples.data());
 		}
 	}
 
 	// -----------------------------------------------------------
 	// iXML CHUNK
+	int indexOfXMLChunk = getIndexOfChunk(fileData, "iXML", 12);
 	if (indexOfXMLChunk != -1)
 	{
 		int32_t chunkSize = fourBytesToInt(fileData, indexOfXMLChunk + 4);
@@ -904,51 +996,8 @@ bool AudioFile<T>::saveToWaveFile(std::string filePath)
 	addStringToFileData(fileData, "data");
 	addInt32ToFileData(fileData, dataChunkSize);
 
-	for (int i = 0; i < getNumSamplesPerChannel(); i++)
-	{
-		for (int channel = 0; channel < getNumChannels(); channel++)
-		{
-			if (bitDepth == 8)
-			{
-				uint8_t byte = sampleToSingleByte(samples[channel][i]);
-				fileData.push_back(byte);
-			}
-			else if (bitDepth == 16)
-			{
-				int16_t sampleAsInt = sampleToSixteenBitInt(samples[channel][i]);
-				addInt16ToFileData(fileData, sampleAsInt);
-			}
-			else if (bitDepth == 24)
-			{
-				int32_t sampleAsIntAgain = (int32_t)(samples[channel][i] * (T)8388608.);
-
-				uint8_t bytes[3];
-				bytes[2] = (uint8_t)(sampleAsIntAgain >> 16) & 0xFF;
-				bytes[1] = (uint8_t)(sampleAsIntAgain >> 8) & 0xFF;
-				bytes[0] = (uint8_t)sampleAsIntAgain & 0xFF;
-
-				fileData.push_back(bytes[0]);
-				fileData.push_back(bytes[1]);
-				fileData.push_back(bytes[2]);
-			}
-			else if (bitDepth == 32)
-			{
-				int32_t sampleAsInt;
-
-				if (audioFormat == WavAudioFormat::IEEEFloat)
-					sampleAsInt = (int32_t) reinterpret_cast<int32_t&> (samples[channel][i]);
-				else // assume PCM
-					sampleAsInt = (int32_t)(samples[channel][i] * std::numeric_limits<int32_t>::max());
-
-				addInt32ToFileData(fileData, sampleAsInt, Endianness::LittleEndian);
-			}
-			else
-			{
-				assert(false && "Trying to write a file with unsupported bit depth");
-				return false;
-			}
-		}
-	}
+	if (!addSamplesToWaveData(fileData))
+		return false;
 
 	// -----------------------------------------------------------
 	// iXML CHUNK
@@ -970,6 +1019,58 @@ bool AudioFile<T>::saveToWaveFile(std::string filePath)
 	return writeDataToFile(fileData, filePath);
 }
 
+//=============================================================
+template <class T>
+bool AudioFile<T>::addSamplesToWaveData(std::vector<uint8_t>& fileData)
+{
+	if (bitDepth != 8 && bitDepth != 16 && bitDepth != 24 && bitDepth != 32)
+	{
+		assert(false && "Trying to write a file with unsupported bit depth");
+		return false;
+	}
+
+	int numChannels = getNumChannels();
+	int numSamples = getNumSamplesPerChannel();
+	int numBytesPerBlock = numChannels * (bitDepth / 8);
+
+	size_t samplesStartIndex = fileData.size();
+	fileData.resize(samplesStartIndex + (size_t)numSamples * numBytesPerBlock);
+
+	// the reverse of decodeWaveFile: interleave a block of frames, then convert it into place
+	const int numFramesPerBlock = 1024;
+	std::vector<T> interleavedSamples(numChannels > 1 ? (size_t)numFramesPerBlock * numChannels : 0);
+	std::vector<const T*> channelSamples(numChannels);
+
+	for (int firstFrame = 0; firstFrame < numSamples; firstFrame += numFramesPerBlock)
+	{
+		int numFrames = std::min(numFramesPerBlock, numSamples - firstFrame);
+		size_t numValues = (size_t)numFrames * numChannels;
+		uint8_t* destination = fileData.data() + samplesStartIndex + (size_t)firstFrame * numBytesPerBlock;
+		const T* source = samples[0].data() + firstFrame;
+
+		if (numChannels > 1)
+		{
+			for (int channel = 0; channel < numChannels; channel++)
+				channelSamples[channel] = samples[channel].data() + firstFrame;
+
+			AudioSampleConversion::interleave(channelSamples.data(), numChannels, (size_t)numFrames, interleavedSamples.data());
+			source = interleavedSamples.data();
+		}
+
+		// 32 bit files are always written as floats
+		if (bitDepth == 8)
+			AudioSampleConversion::samplesToPcm8(source, destination, numValues);
+		else if (bitDepth == 16)
+			AudioSampleConversion::samplesToPcm16(source, destination, numValues);
+		else if (bitDepth == 24)
+			AudioSampleConversion::samplesToPcm24(source, destination, numValues);
+		else
+			AudioSampleConversion::samplesToFloat32(source, destination, numValues);
+	}
+
+	return true;
+}
+
 //=============================================================
 template <class T>
 bool AudioFile<T>::saveToAiffFile(std::string filePath)
@@ -0,0 +1,560 @@
+//=======================================================================
+/** @file AudioSampleConversion.h
+ *
+ * Bulk converters between the sample formats stored in .WAV files and
+ * floating point samples, plus interleaving and deinterleaving of channels.
+ *
+ * Every converter works on a run of interleaved values. The float versions
+ * are vectorised with AVX2 or SSE2 when the compiler targets them (define
+ * AUDIOFILE_DISABLE_SIMD to turn this off) and give exactly the same results
+ * as the scalar versions, which are also used for any other sample type.
+ * Multi-byte values are stored little endian, as they are in a .WAV file.
+ */
+ //=======================================================================
+
+#ifndef _AS_AudioSampleConversion_h
+#define _AS_AudioSampleConversion_h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if !defined (AUDIOFILE_DISABLE_SIMD)
+#if defined (__AVX2__)
+#define AUDIOFILE_USE_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIOFILE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+#endif
+
+namespace AudioSampleConversion
+{
+	//=============================================================
+	// Single sample conversions. The bulk converters below, vectorised or not, all match these exactly
+
+	template <class T>
+	inline T pcm8ToSample(const uint8_t* source)
+	{
+		return static_cast<T> (source[0] - 128) / static_cast<T> (128.);
+	}
+
+	template <class T>
+	inline T pcm16ToSample(const uint8_t* source)
+	{
+		return static_cast<T> ((int16_t)(source[0] | (source[1] << 8))) / static_cast<T> (32768.);
+	}
+
+	template <class T>
+	inline T pcm24ToSample(const uint8_t* source)
+	{
+		// shifting the top byte into the top of an int32 and back down sign extends it
+		return (T)((int32_t)(((uint32_t)source[2] << 24) | (source[1] << 16) | (source[0] << 8)) >> 8) / (T)8388608.;
+	}
+
+	template <class T>
+	inline T pcm32ToSample(const uint8_t* source)
+	{
+		int32_t sampleAsInt = (int32_t)((uint32_t)source[0] | (source[1] << 8) | (source[2] << 16) | ((uint32_t)source[3] << 24));
+		return (T)sampleAsInt / static_cast<float> (std::numeric_limits<std::int32_t>::max());
+	}
+
+	template <class T>
+	inline T float32ToSample(const uint8_t* source)
+	{
+		uint32_t sampleAsInt = (uint32_t)source[0] | (source[1] << 8) | (source[2] << 16) | ((uint32_t)source[3] << 24);
+		float sample;
+		memcpy(&sample, &sampleAsInt, sizeof(float));
+		return (T)sample;
+	}
+
+	template <class T>
+	inline T clampSample(T sample)
+	{
+		sample = std::min(sample, (T)1.);
+		sample = std::max(sample, (T)-1.);
+		return sample;
+	}
+
+	template <class T>
+	inline void sampleToPcm8(T sample, uint8_t* destination)
+	{
+		sample = clampSample(sample);
+		sample = (sample + 1.) / 2.;
+		destination[0] = static_cast<uint8_t> (sample * 255.);
+	}
+
+	template <class T>
+	inline void sampleToPcm16(T sample, uint8_t* destination)
+	{
+		int16_t sampleAsInt = static_cast<int16_t> (clampSample(sample) * 32767.);
+		destination[0] = (uint8_t)(sampleAsInt & 0xFF);
+		destination[1] = (uint8_t)((sampleAsInt >> 8) & 0xFF);
+	}
+
+	template <class T>
+	inline void sampleToPcm24(T sample, uint8_t* destination)
+	{
+		int32_t sampleAsInt = (int32_t)(sample * (T)8388608.);
+		destination[0] = (uint8_t)(sampleAsInt & 0xFF);
+		destination[1] = (uint8_t)((sampleAsInt >> 8) & 0xFF);
+		destination[2] = (uint8_t)((sampleAsInt >> 16) & 0xFF);
+	}
+
+	inline void writeInt32(int32_t value, uint8_t* destination)
+	{
+		destination[0] = (uint8_t)(value & 0xFF);
+		destination[1] = (uint8_t)((value >> 8) & 0xFF);
+		destination[2] = (uint8_t)((value >> 16) & 0xFF);
+		destination[3] = (uint8_t)((value >> 24) & 0xFF);
+	}
+
+	template <class T>
+	inline void sampleToPcm32(T sample, uint8_t* destination)
+	{
+		writeInt32((int32_t)(sample * std::numeric_limits<int32_t>::max()), destination);
+	}
+
+	template <class T>
+	inline void sampleToFloat32(T sample, uint8_t* destination)
+	{
+		float sampleAsFloat = (float)sample;
+		int32_t sampleAsInt;
+		memcpy(&sampleAsInt, &sampleAsFloat, sizeof(float));
+		writeInt32(sampleAsInt, destination);
+	}
+
+	//=============================================================
+	// Bulk conversions from file bytes to samples, for any sample type
+
+	template <class T>
+	void pcm8ToSamples(const uint8_t* source, T* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			destination[i] = pcm8ToSample<T>(source + i);
+	}
+
+	template <class T>
+	void pcm16ToSamples(const uint8_t* source, T* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			destination[i] = pcm16ToSample<T>(source + 2 * i);
+	}
+
+	template <class T>
+	void pcm24ToSamples(const uint8_t* source, T* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			destination[i] = pcm24ToSample<T>(source + 3 * i);
+	}
+
+	template <class T>
+	void pcm32ToSamples(const uint8_t* source, T* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			destination[i] = pcm32ToSample<T>(source + 4 * i);
+	}
+
+	template <class T>
+	void float32ToSamples(const uint8_t* source, T* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			destination[i] = float32ToSample<T>(source + 4 * i);
+	}
+
+	//=============================================================
+	// Bulk conversions from samples to file bytes, for any sample type
+
+	template <class T>
+	void samplesToPcm8(const T* source, uint8_t* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			sampleToPcm8(source[i], destination + i);
+	}
+
+	template <class T>
+	void samplesToPcm16(const T* source, uint8_t* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			sampleToPcm16(source[i], destination + 2 * i);
+	}
+
+	template <class T>
+	void samplesToPcm24(const T* source, uint8_t* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			sampleToPcm24(source[i], destination + 3 * i);
+	}
+
+	template <class T>
+	void samplesToPcm32(const T* source, uint8_t* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			sampleToPcm32(source[i], destination + 4 * i);
+	}
+
+	template <class T>
+	void samplesToFloat32(const T* source, uint8_t* destination, size_t numValues)
+	{
+		for (size_t i = 0; i < numValues; i++)
+			sampleToFloat32(source[i], destination + 4 * i);
+	}
+
+	//=============================================================
+	/** Splits numFrames interleaved frames into one array per channel */
+	template <class T>
+	void deinterleave(const T* interleaved, int numChannels, size_t numFrames, T* const* channels)
+	{
+		for (int channel = 0; channel < numChannels; channel++)
+		{
+			const T* source = interleaved + channel;
+			T* destination = channels[channel];
+
+			for (size_t i = 0; i < numFrames; i++, source += numChannels)
+				destination[i] = *source;
+		}
+	}
+
+	/** Joins one array per channel into numFrames interleaved frames */
+	template <class T>
+	void interleave(const T* const* channels, int numChannels, size_t numFrames, T* interleaved)
+	{
+		for (int channel = 0; channel < numChannels; channel++)
+		{
+			const T* source = channels[channel];
+			T* destination = interleaved + channel;
+
+			for (size_t i = 0; i < numFrames; i++, destination += numChannels)
+				*destination = source[i];
+		}
+	}
+
+	//=============================================================
+	// Float overloads. Overload resolution prefers these to the templates above for float samples
+
+	inline void pcm8ToSamples(const uint8_t* source, float* destination, size_t numValues)
+	{
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_AVX2)
+		const __m256i offset8 = _mm256_set1_epi32(128);
+		const __m256 scale8 = _mm256_set1_ps(1.f / 128.f);
+		for (; i + 8 <= numValues; i += 8)
+		{
+			__m256i values = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(source + i)));
+			values = _mm256_sub_epi32(values, offset8);
+			_mm256_storeu_ps(destination + i, _mm256_mul_ps(_mm256_cvtepi32_ps(values), scale8));
+		}
+#endif
+#if defined (AUDIOFILE_USE_SSE2)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i offset = _mm_set1_epi16(128);
+		const __m128 scale = _mm_set1_ps(1.f / 128.f);
+		for (; i + 8 <= numValues; i += 8)
+		{
+			__m128i values = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(source + i)), zero), offset);
+			__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+			__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+			_mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+			_mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+		}
+#endif
+		for (; i < numValues; i++)
+			destination[i] = pcm8ToSample<float>(source + i);
+	}
+
+	inline void pcm16ToSamples(const uint8_t* source, float* destination, size_t numValues)
+	{
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_AVX2)
+		const __m256 scale16 = _mm256_set1_ps(1.f / 32768.f);
+		for (; i + 16 <= numValues; i += 16)
+		{
+			__m256i low = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(source + 2 * i)));
+			__m256i high = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(source + 2 * i + 16)));
+			_mm256_storeu_ps(destination + i, _mm256_mul_ps(_mm256_cvtepi32_ps(low), scale16));
+			_mm256_storeu_ps(destination + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high), scale16));
+		}
+#endif
+#if defined (AUDIOFILE_USE_SSE2)
+		const __m128 scale = _mm_set1_ps(1.f / 32768.f);
+		for (; i + 8 <= numValues; i += 8)
+		{
+			__m128i values = _mm_loadu_si128((const __m128i*)(source + 2 * i));
+			__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+			__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+			_mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+			_mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+		}
+#endif
+		for (; i < numValues; i++)
+			destination[i] = pcm16ToSample<float>(source + 2 * i);
+	}
+
+	inline void pcm24ToSamples(const uint8_t* source, float* destination, size_t numValues)
+	{
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_AVX2)
+		// eight samples are 24 bytes, which are spread four per 128 bit lane with the low byte of each int left zero
+		const __m256i spreadDwords = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+		const __m256i spreadBytes = _mm256_setr_epi8(
+			-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+			-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+		const __m256 scale24 = _mm256_set1_ps(1.f / 8388608.f);
+
+		// each load reads 32 bytes, so stop while there are still 8 spare bytes after the 24 used
+		for (; i + 11 <= numValues; i += 8)
+		{
+			__m256i bytes = _mm256_loadu_si256((const __m256i*)(source + 3 * i));
+			__m256i values = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(bytes, spreadDwords), spreadBytes);
+			values = _mm256_srai_epi32(values, 8);
+			_mm256_storeu_ps(destination + i, _mm256_mul_ps(_mm256_cvtepi32_ps(values), scale24));
+		}
+#endif
+#if defined (AUDIOFILE_USE_SSE2)
+		const __m128 scale = _mm_set1_ps(1.f / 8388608.f);
+
+		// each sample is read as four bytes, so stop while there is still a spare byte after the last one
+		for (; i + 5 <= numValues; i += 4)
+		{
+			int32_t words[4];
+			memcpy(words, source + 3 * i, 4);
+			memcpy(words + 1, source + 3 * i + 3, 4);
+			memcpy(words + 2, source + 3 * i + 6, 4);
+			memcpy(words + 3, source + 3 * i + 9, 4);
+
+			__m128i values = _mm_loadu_si128((const __m128i*)words);
+			values = _mm_srai_epi32(_mm_slli_epi32(values, 8), 8);
+			_mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(values), scale));
+		}
+#endif
+		for (; i < numValues; i++)
+			destination[i] = pcm24ToSample<float>(source + 3 * i);
+	}
+
+	inline void pcm32ToSamples(const uint8_t* source, float* destination, size_t numValues)
+	{
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_AVX2)
+		const __m256 scale32 = _mm256_set1_ps(1.f / 2147483648.f);
+		for (; i + 8 <= numValues; i += 8)
+		{
+			__m256i values = _mm256_loadu_si256((const __m256i*)(source + 4 * i));
+			_mm256_storeu_ps(destination + i, _mm256_mul_ps(_mm256_cvtepi32_ps(values), scale32));
+		}
+#endif
+#if defined (AUDIOFILE_USE_SSE2)
+		const __m128 scale = _mm_set1_ps(1.f / 2147483648.f);
+		for (; i + 4 <= numValues; i += 4)
+		{
+			__m128i values = _mm_loadu_si128((const __m128i*)(source + 4 * i));
+			_mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(values), scale));
+		}
+#endif
+		for (; i < numValues; i++)
+			destination[i] = pcm32ToSample<float>(source + 4 * i);
+	}
+
+	inline void float32ToSamples(const uint8_t* source, float* destination, size_t numValues)
+	{
+#if defined (AUDIOFILE_USE_SSE2)
+		memcpy(destination, source, numValues * sizeof(float));
+#else
+		for (size_t i = 0; i < numValues; i++)
+			destination[i] = float32ToSample<float>(source + 4 * i);
+#endif
+	}
+
+#if defined (AUDIOFILE_USE_SSE2)
+	/** Clamps four samples to -1..1, scales them in double precision and truncates them to ints, as the scalar code does */
+	inline __m128i clampScaleAndTruncate(__m128 samples, __m128d scale)
+	{
+		samples = _mm_max_ps(_mm_min_ps(samples, _mm_set1_ps(1.f)), _mm_set1_ps(-1.f));
+		__m128i low = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(samples), scale));
+		__m128i high = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(samples, samples)), scale));
+		return _mm_unpacklo_epi64(low, high);
+	}
+#endif
+
+	inline void samplesToPcm8(const float* source, uint8_t* destination, size_t numValues)
+	{
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_SSE2)
+		const __m128d scale = _mm_set1_pd(255.);
+		const __m128 one = _mm_set1_ps(1.f);
+		const __m128 half = _mm_set1_ps(0.5f);
+		for (; i + 8 <= numValues; i += 8)
+		{
+			// clamping first keeps (sample + 1) / 2 in 0..1, so the extra clamp inside is a no-op
+			__m128 low = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(source + i), one), _mm_set1_ps(-1.f));
+			__m128 high = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(source + i + 4), one), _mm_set1_ps(-1.f));
+			low = _mm_mul_ps(_mm_add_ps(low, one), half);
+			high = _mm_mul_ps(_mm_add_ps(high, one), half);
+
+			__m128i values = _mm_packs_epi32(clampScaleAndTruncate(low, scale), clampScaleAndTruncate(high, scale));
+			_mm_storel_epi64((__m128i*)(destination + i), _mm_packus_epi16(values, values));
+		}
+#endif
+		for (; i < numValues; i++)
+			sampleToPcm8(source[i], destination + i);
+	}
+
+	inline void samplesToPcm16(const float* source, uint8_t* destination, size_t numValues)
+	{
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_AVX2)
+		const __m256d scale16 = _mm256_set1_pd(32767.);
+		const __m256 one8 = _mm256_set1_ps(1.f);
+		const __m256 minusOne8 = _mm256_set1_ps(-1.f);
+		for (; i + 8 <= numValues; i += 8)
+		{
+			__m256 samples = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(source + i), one8), minusOne8);
+			__m128i low = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(samples)), scale16));
+			__m128i high = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(samples, 1)), scale16));
+			_mm_storeu_si128((__m128i*)(destination + 2 * i), _mm_packs_epi32(low, high));
+		}
+#endif
+#if defined (AUDIOFILE_USE_SSE2)
+		const __m128d scale = _mm_set1_pd(32767.);
+		for (; i + 8 <= numValues; i += 8)
+		{
+			__m128i low = clampScaleAndTruncate(_mm_loadu_ps(source + i), scale);
+			__m128i high = clampScaleAndTruncate(_mm_loadu_ps(source + i + 4), scale);
+			_mm_storeu_si128((__m128i*)(destination + 2 * i), _mm_packs_epi32(low, high));
+		}
+#endif
+		for (; i < numValues; i++)
+			sampleToPcm16(source[i], destination + 2 * i);
+	}
+
+	inline void samplesToPcm24(const float* source, uint8_t* destination, size_t numValues)
+	{
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_SSE2)
+		const __m128 scale = _mm_set1_ps(8388608.f);
+
+		// each sample is written as four bytes and the next one overwrites the fourth, so the
+		// last sample of the run is left to the scalar loop
+		for (; i + 5 <= numValues; i += 4)
+		{
+			int32_t words[4];
+			_mm_storeu_si128((__m128i*)words, _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(source + i), scale)));
+			memcpy(destination + 3 * i, words, 4);
+			memcpy(destination + 3 * i + 3, words + 1, 4);
+			memcpy(destination + 3 * i + 6, words + 2, 4);
+			memcpy(destination + 3 * i + 9, words + 3, 4);
+		}
+#endif
+		for (; i < numValues; i++)
+			sampleToPcm24(source[i], destination + 3 * i);
+	}
+
+	inline void samplesToPcm32(const float* source, uint8_t* destination, size_t numValues)
+	{
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_SSE2)
+		const __m128 scale = _mm_set1_ps((float)std::numeric_limits<int32_t>::max());
+		for (; i + 4 <= numValues; i += 4)
+		{
+			__m128i values = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(source + i), scale));
+			_mm_storeu_si128((__m128i*)(destination + 4 * i), values);
+		}
+#endif
+		for (; i < numValues; i++)
+			sampleToPcm32(source[i], destination + 4 * i);
+	}
+
+	inline void samplesToFloat32(const float* source, uint8_t* destination, size_t numValues)
+	{
+#if defined (AUDIOFILE_USE_SSE2)
+		memcpy(destination, source, numValues * sizeof(float));
+#else
+		for (size_t i = 0; i < numValues; i++)
+			sampleToFloat32(source[i], destination + 4 * i);
+#endif
+	}
+
+	inline void deinterleave(const float* interleaved, int numChannels, size_t numFrames, float* const* channels)
+	{
+		if (numChannels != 2)
+		{
+			deinterleave<float>(interleaved, numChannels, numFrames, channels);
+			return;
+		}
+
+		float* left = channels[0];
+		float* right = channels[1];
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_AVX2)
+		for (; i + 8 <= numFrames; i += 8)
+		{
+			__m256 first = _mm256_loadu_ps(interleaved + 2 * i);
+			__m256 second = _mm256_loadu_ps(interleaved + 2 * i + 8);
+
+			// the shuffles work within 128 bit lanes, so put the lanes back in order afterwards
+			__m256 lefts = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+			__m256 rights = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+			_mm256_storeu_ps(left + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(lefts), _MM_SHUFFLE(3, 1, 2, 0))));
+			_mm256_storeu_ps(right + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(rights), _MM_SHUFFLE(3, 1, 2, 0))));
+		}
+#endif
+#if defined (AUDIOFILE_USE_SSE2)
+		for (; i + 4 <= numFrames; i += 4)
+		{
+			__m128 first = _mm_loadu_ps(interleaved + 2 * i);
+			__m128 second = _mm_loadu_ps(interleaved + 2 * i + 4);
+			_mm_storeu_ps(left + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(right + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+#endif
+		for (; i < numFrames; i++)
+		{
+			left[i] = interleaved[2 * i];
+			right[i] = interleaved[2 * i + 1];
+		}
+	}
+
+	inline void interleave(const float* const* channels, int numChannels, size_t numFrames, float* interleaved)
+	{
+		if (numChannels != 2)
+		{
+			interleave<float>(channels, numChannels, numFrames, interleaved);
+			return;
+		}
+
+		const float* left = channels[0];
+		const float* right = channels[1];
+		size_t i = 0;
+#if defined (AUDIOFILE_USE_AVX2)
+		for (; i + 8 <= numFrames; i += 8)
+		{
+			__m256 lefts = _mm256_loadu_ps(left + i);
+			__m256 rights = _mm256_loadu_ps(right + i);
+
+			// unpacking works within 128 bit lanes, so swap the middle lanes of the two results
+			__m256 low = _mm256_unpacklo_ps(lefts, rights);
+			__m256 high = _mm256_unpackhi_ps(lefts, rights);
+			_mm256_storeu_ps(interleaved + 2 * i, _mm256_permute2f128_ps(low, high, 0x20));
+			_mm256_storeu_ps(interleaved + 2 * i + 8, _mm256_permute2f128_ps(low, high, 0x31));
+		}
+#endif
+#if defined (AUDIOFILE_USE_SSE2)
+		for (; i + 4 <= numFrames; i += 4)
+		{
+			__m128 lefts = _mm_loadu_ps(left + i);
+			__m128 rights = _mm_loadu_ps(right + i);
+			_mm_storeu_ps(interleaved + 2 * i, _mm_unpacklo_ps(lefts, rights));
+			_mm_storeu_ps(interleaved + 2 * i + 4, _mm_unpackhi_ps(lefts, rights));
+		}
+#endif
+		for (; i < numFrames; i++)
+		{
+			interleaved[2 * i] = left[i];
+			interleaved[2 * i + 1] = right[i];
+		}
+	}
+}
+
+#endif /* _AS_AudioSampleConversion_h */